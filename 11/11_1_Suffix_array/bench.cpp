@@ -0,0 +1,360 @@
+/*
+  Benchmarks for suffix array tools. Inputs are generated, results are printed to stdout
+  one line per measurement as space separated key=value pairs, first key is always bench.
+  Peak memory and cache misses are reported as -1 where the platform does not provide them.
+*/
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif // __linux__
+
+#include "../../common/fast_io.hpp"
+#include "../../common/compressed_lcp.hpp"
+#include "suffix_array.hpp"
+#include "lcp_rmq.hpp"
+#include "corpus.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/*
+  Wall time, peak resident memory above the resident size at start and last level cache misses
+  of a measured section. Peak is reset through /proc/self/clear_refs, cache misses come from perf_event_open.
+*/
+class ResourceProbe {
+public:
+    struct Result {
+        double seconds;
+        long long peak_rss_kb;
+        long long cache_misses;
+    };
+
+    ResourceProbe() {
+#ifdef __linux__
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        perf_fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif // __linux__
+    }
+    ResourceProbe(const ResourceProbe&) = delete;
+    ResourceProbe& operator = (const ResourceProbe&) = delete;
+    ~ResourceProbe() {
+#ifdef __linux__
+        if (perf_fd >= 0) {
+            close(perf_fd);
+        }
+#endif // __linux__
+    }
+
+    void start() {
+#ifdef __linux__
+        std::ofstream("/proc/self/clear_refs") << "5";
+        start_rss_kb = status_kb("VmRSS:");
+        if (perf_fd >= 0) {
+            ioctl(perf_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(perf_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif // __linux__
+        start_time = Clock::now();
+    }
+
+    Result stop() {
+        Result result{ seconds_since(start_time), -1, -1 };
+#ifdef __linux__
+        if (perf_fd >= 0) {
+            ioctl(perf_fd, PERF_EVENT_IOC_DISABLE, 0);
+            long long count = 0;
+            if (read(perf_fd, &count, sizeof(count)) == sizeof(count)) {
+                result.cache_misses = count;
+            }
+        }
+        const auto peak_kb = status_kb("VmHWM:");
+        if (peak_kb >= 0 && start_rss_kb >= 0) {
+            result.peak_rss_kb = std::max(0ll, peak_kb - start_rss_kb);
+        }
+#endif // __linux__
+        return result;
+    }
+
+private:
+#ifdef __linux__
+    static long long status_kb(const std::string& key) {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.compare(0, key.size(), key) == 0) {
+                return std::stoll(line.substr(key.size()));
+            }
+        }
+        return -1;
+    }
+
+    int perf_fd = -1;
+    long long start_rss_kb = -1;
+#endif // __linux__
+    Clock::time_point start_time;
+};
+
+void print_resources(const std::string& prefix, const ResourceProbe::Result& result) {
+    std::cout << " " << prefix << "_s=" << result.seconds
+              << " " << prefix << "_peak_rss_kb=" << result.peak_rss_kb
+              << " " << prefix << "_cache_misses=" << result.cache_misses;
+}
+
+struct Corpus {
+    std::string name;
+    std::string text;
+};
+
+std::vector<Corpus> generate_corpora(size_t n, std::mt19937& rng) {
+    return {
+        { "random", random_text(n, 26, rng) },
+        { "binary", random_text(n, 2, rng) },
+        { "dna", dna_text(n, rng) },
+        { "natural", natural_text(n, rng) },
+        { "fibonacci", fibonacci_text(n) },
+        { "periodic", periodic_text(n, "abaabaab") },
+        { "same_char", periodic_text(n, "a") },
+    };
+}
+
+/*
+  Suffix array builders to compare, all of them return suffix array of str with its placeholder
+*/
+std::vector<size_t> naive_suffix_array(const std::string& str) {
+    std::vector<size_t> suffix_array(str.size());
+    for (size_t i = 0; i < suffix_array.size(); ++i) {
+        suffix_array[i] = i;
+    }
+    const std::string_view view(str);
+    std::sort(suffix_array.begin(), suffix_array.end(), [&](size_t a, size_t b) { return view.substr(a) < view.substr(b); });
+    return suffix_array;
+}
+
+struct Engine {
+    const char* name;
+    std::vector<size_t> (*build)(const std::string&);
+};
+
+void bench_suffix_array(const Corpus& corpus, const std::vector<Engine>& engines, ResourceProbe& probe) {
+    const auto str = corpus.text + PLACEHOLDER;
+    std::vector<size_t> reference;
+    for (const auto& engine : engines) {
+        probe.start();
+        const auto suffix_array = engine.build(str);
+        const auto sa_result = probe.stop();
+        probe.start();
+        const auto lcp = get_lcp(str, suffix_array);
+        const auto lcp_result = probe.stop();
+        if (reference.empty()) {
+            reference = suffix_array;
+        }
+        std::cout << "bench=suffix_array corpus=" << corpus.name << " engine=" << engine.name << " n=" << corpus.text.size();
+        print_resources("sa", sa_result);
+        print_resources("lcp", lcp_result);
+        std::cout << " ok=" << (suffix_array == reference ? 1 : 0) << "\n";
+    }
+}
+
+size_t naive_lcp(const std::string& str, size_t i, size_t j) {
+    size_t len = 0;
+    for (; str[i + len] == str[j + len] && str[i + len] != PLACEHOLDER; ++len);
+    return len;
+}
+
+void bench_suffix_lcp(const Corpus& corpus, size_t queries_num, std::mt19937& rng) {
+    const auto str = corpus.text + PLACEHOLDER;
+    const auto n = str.size();
+    const auto suffix_array = get_suffix_array(str);
+    auto lcp = get_lcp(str, suffix_array);
+
+    auto start = Clock::now();
+    const SuffixLcp suffix_lcp(str, suffix_array, std::move(lcp));
+    const auto build_time = seconds_since(start);
+
+    std::vector<std::pair<size_t, size_t>> queries(queries_num);
+    for (auto& [i, j] : queries) {
+        i = rng() % (n - 1);
+        j = rng() % (n - 1);
+    }
+    std::vector<size_t> answers;
+    start = Clock::now();
+    suffix_lcp.get_batch(queries, answers);
+    const auto rmq_time = seconds_since(start);
+
+    // naive answers cost O(lcp) each, so on repetitive corpora only a sample is checked
+    static const size_t NAIVE_QUERIES = 10000;
+    const auto naive_num = std::min(NAIVE_QUERIES, queries_num);
+    start = Clock::now();
+    size_t mismatches = 0;
+    for (size_t q = 0; q < naive_num; ++q) {
+        mismatches += naive_lcp(str, queries[q].first, queries[q].second) != answers[q] ? 1 : 0;
+    }
+    const auto naive_time = seconds_since(start);
+
+    std::cout << "bench=suffix_lcp corpus=" << corpus.name << " n=" << n - 1 << " queries=" << queries_num
+              << " build_s=" << build_time << " rmq_s=" << rmq_time
+              << " naive_queries=" << naive_num << " naive_s=" << naive_time
+              << " words_per_char=" << static_cast<double>(suffix_lcp.bytes()) / sizeof(size_t) / n
+              << " ok=" << (mismatches ? 0 : 1) << "\n";
+}
+
+void bench_compressed_lcp(const Corpus& corpus, std::mt19937& rng) {
+    const auto str = corpus.text + PLACEHOLDER;
+    const auto n = str.size();
+    const auto lcp = get_lcp(str, get_suffix_array(str));
+
+    auto start = Clock::now();
+    const CompressedLcp compressed(lcp);
+    const auto build_time = seconds_since(start);
+
+    start = Clock::now();
+    size_t plain_sum = 0;
+    for (const auto value : lcp) {
+        plain_sum += value;
+    }
+    const auto plain_scan_time = seconds_since(start);
+
+    start = Clock::now();
+    size_t scan_sum = 0;
+    CompressedLcp::Scanner scanner(compressed);
+    for (size_t i = 0; i < n; ++i) {
+        scan_sum += scanner[i];
+    }
+    const auto scan_time = seconds_since(start);
+
+    std::vector<size_t> indices(n);
+    for (auto& i : indices) {
+        i = rng() % n;
+    }
+    start = Clock::now();
+    size_t mismatches = 0;
+    for (const auto i : indices) {
+        mismatches += compressed[i] != lcp[i] ? 1 : 0;
+    }
+    const auto random_time = seconds_since(start);
+
+    std::cout << "bench=compressed_lcp corpus=" << corpus.name << " n=" << n - 1
+              << " bytes_per_entry=" << static_cast<double>(compressed.bytes()) / n
+              << " exceptions=" << compressed.exceptions_count() << " plain=" << (compressed.is_plain() ? 1 : 0)
+              << " build_s=" << build_time << " plain_scan_s=" << plain_scan_time << " scan_s=" << scan_time
+              << " random_s=" << random_time
+              << " ok=" << ((mismatches || plain_sum != scan_sum) ? 0 : 1) << "\n";
+}
+
+/*
+  Same workload through iostreams and through fast_io: n short words and numbers are read,
+  then n numbers are written. Streams live in memory, so only parsing and formatting are measured.
+*/
+void bench_io(size_t n, std::mt19937& rng) {
+    std::string input;
+    for (size_t i = 0; i < n; ++i) {
+        input += random_text(1 + rng() % 8, 26, rng);
+        input += ' ';
+        input += std::to_string(rng());
+        input += '\n';
+    }
+    std::vector<std::string> words(n);
+    std::vector<size_t> numbers(n);
+
+    std::istringstream stream_in(input);
+    auto start = Clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        stream_in >> words[i] >> numbers[i];
+    }
+    const auto stream_read_time = seconds_since(start);
+    const auto stream_checksum = numbers.back();
+
+    std::istringstream fast_stream_in(input);
+    start = Clock::now();
+    FastReader in(fast_stream_in);
+    for (size_t i = 0; i < n; ++i) {
+        in.read(words[i]);
+        in.read(numbers[i]);
+    }
+    const auto fast_read_time = seconds_since(start);
+
+    std::ostringstream stream_out;
+    start = Clock::now();
+    for (const auto number : numbers) {
+        stream_out << number << " ";
+    }
+    const auto stream_write_time = seconds_since(start);
+
+    std::ostringstream fast_stream_out;
+    start = Clock::now();
+    {
+        FastWriter out(fast_stream_out);
+        for (const auto number : numbers) {
+            out << number << ' ';
+        }
+    }
+    const auto fast_write_time = seconds_since(start);
+
+    const bool same = stream_checksum == numbers.back() && stream_out.str() == fast_stream_out.str();
+    std::cout << "bench=io n=" << n << " read_iostream_s=" << stream_read_time << " read_fast_s=" << fast_read_time
+              << " write_iostream_s=" << stream_write_time << " write_fast_s=" << fast_write_time
+              << " ok=" << (same ? 1 : 0) << "\n";
+}
+
+/*
+  Usage:
+    bench [--size N] [--naive] [FILE...]
+    --size N    length of generated corpora, 10^6 by default
+    --naive     also build suffix arrays by plain sorting of suffixes, quadratic on repetitive corpora
+    FILE        additional corpora, letters only
+*/
+int main(int argc, char* argv[]) {
+    std::mt19937 rng(2020);
+    size_t n = 1000000;
+    std::vector<Engine> engines = { { "doubling", get_suffix_array } };
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--size" && i + 1 < argc) {
+            n = std::stoul(argv[++i]);
+        } else if (arg == "--naive") {
+            engines.push_back({ "naive", naive_suffix_array });
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    auto corpora = generate_corpora(n, rng);
+    for (const auto& path : files) {
+        corpora.push_back({ path, file_text(path) });
+    }
+
+    ResourceProbe probe;
+    for (const auto& corpus : corpora) {
+        bench_suffix_array(corpus, engines, probe);
+    }
+    for (const auto& corpus : corpora) {
+        bench_suffix_lcp(corpus, n, rng);
+    }
+    for (const auto& corpus : corpora) {
+        bench_compressed_lcp(corpus, rng);
+    }
+    bench_io(n, rng);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,107 @@
+#pragma once
+#ifndef CORPUS_HPP
+#define CORPUS_HPP
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <random>
+#include <fstream>
+
+/*
+  Generators of benchmark inputs over lower case latin letters.
+  Typical cases are random, DNA-like and natural texts; Fibonacci strings, periodic
+  and single char texts are the worst cases for prefix doubling and for lcp computation.
+*/
+
+std::string random_text(size_t n, size_t letters, std::mt19937& rng) {
+    std::string str(n, 'a');
+    for (auto& ch : str) {
+        ch = static_cast<char>('a' + rng() % letters);
+    }
+    return str;
+}
+
+std::string periodic_text(size_t n, const std::string& period) {
+    std::string str(n, 'a');
+    for (size_t i = 0; i < n; ++i) {
+        str[i] = period[i % period.size()];
+    }
+    return str;
+}
+
+// prefix of the infinite Fibonacci word: f(k) = f(k - 1) + f(k - 2), f(1) = "b", f(2) = "a"
+std::string fibonacci_text(size_t n) {
+    std::string prev = "b";
+    std::string cur = "a";
+    while (cur.size() < n) {
+        auto next = cur + prev;
+        prev = std::move(cur);
+        cur = std::move(next);
+    }
+    cur.resize(n);
+    return cur;
+}
+
+/*
+  Random acgt sequence where about half of the text is made of copies of earlier fragments
+  with a few point mutations, like repeats in a genome
+*/
+std::string dna_text(size_t n, std::mt19937& rng) {
+    static const char NUCLEOTIDES[] = "acgt";
+    std::string str;
+    str.reserve(n);
+    while (str.size() < n) {
+        const size_t len = std::min<size_t>(n - str.size(), 100 + rng() % 1000);
+        if (str.size() > len && rng() % 2) {
+            const size_t from = rng() % (str.size() - len);
+            for (size_t i = 0; i < len; ++i) {
+                str += (rng() % 100) ? str[from + i] : NUCLEOTIDES[rng() % 4];
+            }
+        } else {
+            for (size_t i = 0; i < len; ++i) {
+                str += NUCLEOTIDES[rng() % 4];
+            }
+        }
+    }
+    return str;
+}
+
+/*
+  Words of a random vocabulary drawn with Zipf distribution, written without separators
+  since spaces are not in the alphabet
+*/
+std::string natural_text(size_t n, std::mt19937& rng) {
+    static const size_t VOCABULARY_SIZE = 20000;
+    std::vector<std::string> vocabulary(VOCABULARY_SIZE);
+    std::vector<double> weights(VOCABULARY_SIZE);
+    for (size_t i = 0; i < VOCABULARY_SIZE; ++i) {
+        vocabulary[i] = random_text(2 + rng() % 3 + rng() % 6, 26, rng);
+        weights[i] = 1.0 / (i + 1);
+    }
+    std::discrete_distribution<size_t> zipf(weights.begin(), weights.end());
+    std::string str;
+    str.reserve(n + 16);
+    while (str.size() < n) {
+        str += vocabulary[zipf(rng)];
+    }
+    str.resize(n);
+    return str;
+}
+
+/*
+  Letters of a file turned to lower case, everything else is dropped
+*/
+std::string file_text(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::string str;
+    for (char ch; in.get(ch);) {
+        ch = static_cast<char>((ch >= 'A' && ch <= 'Z') ? ch - 'A' + 'a' : ch);
+        if (ch >= 'a' && ch <= 'z') {
+            str += ch;
+        }
+    }
+    return str;
+}
+
+#endif // !CORPUS_HPP
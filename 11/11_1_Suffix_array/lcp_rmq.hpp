@@ -0,0 +1,166 @@
+#pragma once
+#ifndef LCP_RMQ_HPP
+#define LCP_RMQ_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "suffix_array.hpp"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+inline size_t lowest_bit(uint32_t x) {
+    unsigned long index;
+    _BitScanForward(&index, x);
+    return index;
+}
+inline size_t highest_bit(uint32_t x) {
+    unsigned long index;
+    _BitScanReverse(&index, x);
+    return index;
+}
+#else
+inline size_t lowest_bit(uint32_t x) { return __builtin_ctz(x); }
+inline size_t highest_bit(uint32_t x) { return 31 - __builtin_clz(x); }
+#endif
+inline size_t highest_bit(uint64_t x) {
+    const auto high = static_cast<uint32_t>(x >> 32);
+    return high ? 32 + highest_bit(high) : highest_bit(static_cast<uint32_t>(x));
+}
+
+/*
+  Range minimum over lcp array in O(1) per query.
+  Array is split into blocks of 32 values:
+    - inside a block every position keeps a 32-bit mask of the monotonic stack of minimums
+      ending at it, so a minimum on [l, r] inside one block is the lowest bit of mask[r] above l;
+    - minimums of whole blocks go to a sparse table, a query reads one level picked by the highest bit of its length.
+  The lcp array is moved in and owned. On top of its n words, memory is n / 2 words for masks
+  plus (n / 32) * log(n / 32) words for sparse table, under 2n words in total.
+*/
+class LcpRmq {
+public:
+    static const size_t BLOCK = 32;
+
+    explicit LcpRmq(std::vector<size_t> _lcp) : lcp(std::move(_lcp)), masks(lcp.size()) {
+        const auto n = lcp.size();
+        std::vector<size_t> block_min((n + BLOCK - 1) / BLOCK);
+        for (size_t block = 0; block < block_min.size(); ++block) {
+            const auto begin = block * BLOCK;
+            const auto end = std::min(n, begin + BLOCK);
+            uint32_t mask = 0;
+            for (auto i = begin; i < end; ++i) {
+                // drop stack values greater than lcp[i], then push i
+                while (mask && lcp[begin + highest_bit(mask)] > lcp[i]) {
+                    mask ^= uint32_t(1) << highest_bit(mask);
+                }
+                mask |= uint32_t(1) << (i - begin);
+                masks[i] = mask;
+            }
+            block_min[block] = lcp[begin + lowest_bit(masks[end - 1])];
+        }
+        sparse.push_back(std::move(block_min));
+        for (size_t len = 1; 2 * len <= sparse[0].size(); len *= 2) {
+            const auto& prev = sparse.back();
+            std::vector<size_t> level(prev.size() - len);
+            for (size_t i = 0; i < level.size(); ++i) {
+                level[i] = std::min(prev[i], prev[i + len]);
+            }
+            sparse.push_back(std::move(level));
+        }
+    }
+
+    // min(lcp[l..r]), l <= r
+    size_t min(size_t l, size_t r) const {
+        const auto bl = l / BLOCK;
+        const auto br = r / BLOCK;
+        if (bl == br) {
+            return in_block(l, r);
+        }
+        auto result = std::min(in_block(l, bl * BLOCK + BLOCK - 1), in_block(br * BLOCK, r));
+        if (bl + 1 < br) {
+            result = std::min(result, blocks_min(bl + 1, br - 1));
+        }
+        return result;
+    }
+
+    size_t bytes() const {
+        size_t result = lcp.size() * sizeof(size_t) + masks.size() * sizeof(uint32_t);
+        for (const auto& level : sparse) {
+            result += level.size() * sizeof(size_t);
+        }
+        return result;
+    }
+
+private:
+    size_t in_block(size_t l, size_t r) const {
+        const auto begin = l - l % BLOCK;
+        return lcp[begin + lowest_bit(masks[r] & (~uint32_t(0) << (l - begin)))];
+    }
+
+    size_t blocks_min(size_t l, size_t r) const {
+        const auto level = highest_bit(static_cast<uint64_t>(r - l + 1));
+        return std::min(sparse[level][l], sparse[level][r + 1 - (size_t(1) << level)]);
+    }
+
+    std::vector<size_t> lcp;
+    std::vector<uint32_t> masks;
+    std::vector<std::vector<size_t>> sparse;
+};
+
+/*
+  Longest common prefix of two arbitrary suffixes of str (given by their text positions)
+*/
+class SuffixLcp {
+public:
+    SuffixLcp(const std::string& str, const std::vector<size_t>& suffix_array, std::vector<size_t> lcp)
+        : text_size(str.size()), positions(get_suffix_pos(suffix_array)), rmq(std::move(lcp)) {}
+
+    size_t get(size_t i, size_t j) const {
+        if (i == j) {
+            return text_size - 1 - i; // whole suffix without placeholder
+        }
+        auto pi = positions[i];
+        auto pj = positions[j];
+        if (pi > pj) {
+            std::swap(pi, pj);
+        }
+        // lcp[k] keeps common prefix of suffix_array[k] and suffix_array[k + 1]
+        return rmq.min(pi, pj - 1);
+    }
+
+    /*
+      Random queries are bound by cache misses on positions, so ranks of queries a few steps
+      ahead are prefetched while the current one is answered
+    */
+    void get_batch(const std::vector<std::pair<size_t, size_t>>& queries, std::vector<size_t>& answers) const {
+        static const size_t PREFETCH_DISTANCE = 16;
+        answers.resize(queries.size());
+        for (size_t q = 0; q < queries.size(); ++q) {
+            if (q + PREFETCH_DISTANCE < queries.size()) {
+                prefetch(&positions[queries[q + PREFETCH_DISTANCE].first]);
+                prefetch(&positions[queries[q + PREFETCH_DISTANCE].second]);
+            }
+            answers[q] = get(queries[q].first, queries[q].second);
+        }
+    }
+
+    size_t bytes() const { return positions.size() * sizeof(size_t) + rmq.bytes(); }
+
+private:
+    static void prefetch(const void* ptr) {
+#if defined(_MSC_VER)
+        _mm_prefetch(static_cast<const char*>(ptr), _MM_HINT_T0);
+#else
+        __builtin_prefetch(ptr);
+#endif
+    }
+
+    size_t text_size;
+    std::vector<size_t> positions;
+    LcpRmq rmq;
+};
+
+#endif // !LCP_RMQ_HPP
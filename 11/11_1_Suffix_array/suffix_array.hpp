@@ -0,0 +1,106 @@
+#pragma once
+#ifndef SUFFIX_ARRAY_HPP
+#define SUFFIX_ARRAY_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+static const char FIRST_LETTER = 'a';
+static const char PLACEHOLDER = FIRST_LETTER - 1;
+static const size_t VOC_SIZE = 'z' - PLACEHOLDER + 1;
+
+size_t inline char_addr(char ch) {
+    return ch - PLACEHOLDER;
+}
+
+std::vector<size_t> get_suffix_array(const std::string& str) {
+    const auto n = str.length ();
+    size_t count[VOC_SIZE] = { 0 };
+    std::vector<size_t> paddr(n);
+    
+    // Sort first prefix letters
+    for (const auto ch : str) 
+        ++count[char_addr(ch)]; 
+    for (size_t i = 1; i < VOC_SIZE; ++i)
+        count[i] += count[i - 1];
+    for (size_t i = 0; i < n; ++i)
+        paddr[--count[char_addr(str[i])]] = i;
+
+    size_t classes_count = 1;
+    std::vector<size_t> classes(n);
+    classes[paddr[0]] = 0;
+    for (size_t i = 1; i < n; ++i) {
+        classes_count += (str[paddr[i]] != str[paddr[i - 1]]) ? 1 : 0;
+        classes[paddr[i]] = classes_count - 1;
+    }
+
+    // Sort pairs. Pass stops as soon as all classes are distinct.
+    // Class pairs are packed into a single word, so renumbering is a linear scan over keys,
+    // and modular indexing is done with conditional adds instead of branches and divisions.
+    // Classes of a text longer than 2^32 don't fit the halves of a key, then the first classes
+    // are compared separately from pn, which is free after the sort.
+    const bool wide = static_cast<uint64_t>(n) > UINT32_MAX;
+    std::vector<size_t> pn(n);
+    std::vector<uint64_t> keys(n);
+    std::vector<size_t> cnt;
+    for (size_t sub_len = 1; sub_len < n && classes_count < n; sub_len <<= 1) {
+        cnt.assign(classes_count, 0);
+        for (size_t i = 0; i < n; ++i)
+            ++cnt[classes[i]]; // pn is a permutation, so its histogram equals one of all positions
+        for (size_t i = 1; i < classes_count; ++i)
+            cnt[i] += cnt[i - 1];
+        for (size_t i = 0; i < n; ++i)
+            pn[i] = paddr[i] - sub_len + ((paddr[i] < sub_len) ? n : 0);
+        for (size_t i = n - 1; i < n; --i)
+            paddr[--cnt[classes[pn[i]]]] = pn[i];
+        for (size_t i = 0; i < n; ++i) {
+            size_t mid = paddr[i] + sub_len;
+            mid -= (mid >= n) ? n : 0;
+            if (wide) {
+                pn[i] = classes[paddr[i]];
+                keys[i] = classes[mid];
+            } else {
+                keys[i] = (static_cast<uint64_t>(classes[paddr[i]]) << 32) | classes[mid];
+            }
+        }
+        classes_count = 1;
+        classes[paddr[0]] = 0;
+        for (size_t i = 1; i < n; ++i) {
+            classes_count += (keys[i] != keys[i - 1] || (wide && pn[i] != pn[i - 1])) ? 1 : 0;
+            classes[paddr[i]] = classes_count - 1;
+        }
+    }
+
+    return paddr;
+}
+
+std::vector <size_t> get_suffix_pos(const std::vector<size_t>& suffix_array) {
+    std::vector<size_t> suffix_positions(suffix_array.size());
+    for (size_t i = 0; i < suffix_array.size(); ++i) {
+        suffix_positions[suffix_array[i]] = i;
+    }
+    return suffix_positions;
+}
+
+std::vector<size_t> get_lcp(const std::string& str, const std::vector<size_t>& suffix_array) {
+    const auto n = str.size();
+    std::vector<size_t> result(n);
+    size_t cur = 0;
+    const auto pos = get_suffix_pos(suffix_array);
+    for (size_t i = 0; i < n - 1; ++i) {
+        const auto& posi = pos[i];
+        cur -= (cur > 0) ? 1 : 0;
+        if (posi == n - 1) {
+            result[n - 1] = 0;
+            cur = 0;
+        } else {
+            for (auto j = suffix_array[posi + 1]; std::max(i + cur, j + cur) < n && str[i + cur] == str[j + cur]; ++cur);
+        }
+        result[pos[i]] = cur;
+    }
+    return result;
+}
+
+#endif // !SUFFIX_ARRAY_HPP
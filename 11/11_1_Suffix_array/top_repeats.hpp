@@ -0,0 +1,85 @@
+#pragma once
+#ifndef TOP_REPEATS_HPP
+#define TOP_REPEATS_HPP
+
+#include <vector>
+#include <queue>
+#include <algorithm>
+
+struct Repeat {
+    size_t count;
+    size_t length;
+    size_t position; // text position of the first occurrence
+};
+
+// more frequent first, then longer, then earlier in text
+inline bool operator < (const Repeat& lhs, const Repeat& rhs) {
+    if (lhs.count != rhs.count) {
+        return lhs.count > rhs.count;
+    }
+    if (lhs.length != rhs.length) {
+        return lhs.length > rhs.length;
+    }
+    return lhs.position < rhs.position;
+}
+
+/*
+  k most frequent substrings of length at least min_length, which occur at least twice.
+  Every lcp-interval [lb, rb] of suffix array with lcp value l is an inner node of the suffix tree:
+  the longest common prefix of its suffixes has length l and occurs rb - lb + 1 times, shorter prefixes
+  down to the parent's lcp occur the same number of times, so only the longest one is reported.
+  Intervals are enumerated bottom-up with a stack in a single pass over lcp, the best k are kept in a heap,
+  O(n log k) time and O(n) memory in the worst case (stack depth on highly repetitive text).
+*/
+std::vector<Repeat> get_top_repeats(const std::vector<size_t>& suffix_array, const std::vector<size_t>& lcp, size_t k, size_t min_length) {
+    const auto n = suffix_array.size();
+    std::priority_queue<Repeat> best; // the worst of kept repeats on top
+    const auto report = [&](size_t length, size_t lb, size_t rb, size_t position) {
+        if (length < min_length || k == 0) {
+            return;
+        }
+        const Repeat repeat{ rb - lb + 1, length, position };
+        if (best.size() < k) {
+            best.push(repeat);
+        } else if (repeat < best.top()) {
+            best.pop();
+            best.push(repeat);
+        }
+    };
+
+    // open intervals, lcp values strictly increase to the top
+    struct Interval {
+        size_t length;
+        size_t lb;
+        size_t first_pos; // minimal text position among suffixes seen so far
+    };
+    std::vector<Interval> stack{ { 0, 0, suffix_array[0] } };
+    for (size_t i = 0; i < n; ++i) {
+        // lcp[i] is lcp of suffix_array[i] and suffix_array[i + 1], the last one closes everything
+        const auto cur = (i + 1 < n) ? lcp[i] : 0;
+        auto lb = i;
+        auto first_pos = suffix_array[i];
+        while (cur < stack.back().length) {
+            const auto top = stack.back();
+            stack.pop_back();
+            first_pos = std::min(first_pos, top.first_pos);
+            report(top.length, top.lb, i, first_pos);
+            lb = top.lb;
+        }
+        if (cur > stack.back().length) {
+            stack.push_back({ cur, lb, first_pos });
+        } else {
+            stack.back().first_pos = std::min(stack.back().first_pos, first_pos);
+        }
+    }
+
+    std::vector<Repeat> result;
+    result.reserve(best.size());
+    for (; !best.empty(); best.pop()) {
+        result.push_back(best.top());
+    }
+    std::reverse(result.begin(), result.end());
+    return result;
+}
+
+#endif // !TOP_REPEATS_HPP
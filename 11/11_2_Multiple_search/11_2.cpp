@@ -28,14 +28,24 @@ YES
 */
 
 #include <iostream>
+#include <cstdint>
 #include <fstream>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <cstring>
 #include <algorithm>
+#include <thread>
+
+#include "../../common/fast_io.hpp"
+#include "../../common/cli_args.hpp"
+#include "suffix_index.hpp"
+#include "fm_index.hpp"
 
 static const char FIRST_LETTER = 'a';
 static const char PLACEHOLDER = FIRST_LETTER - 1;
 static const size_t VOC_SIZE = 'z' - PLACEHOLDER + 1;
+static const size_t MIN_WORDS_PER_THREAD = 1 << 12;
 
 size_t inline char_addr(char ch) {
     return ch - PLACEHOLDER;
@@ -57,74 +67,550 @@ std::vector<size_t> get_suffix_array(const std::string& str) {
     size_t classes_count = 1;
     std::vector<size_t> classes(n);
     classes[paddr[0]] = 0;
-    for (int i = 1; i < n; ++i) {
+    for (size_t i = 1; i < n; ++i) {
         classes_count += (str[paddr[i]] != str[paddr[i - 1]]) ? 1 : 0;
         classes[paddr[i]] = classes_count - 1;
     }
 
-    // Sort pairs
+    // Sort pairs. Pass stops as soon as all classes are distinct.
+    // Class pairs are packed into a single word, so renumbering is a linear scan over keys,
+    // and modular indexing is done with conditional adds instead of branches and divisions.
+    // Classes of a text longer than 2^32 don't fit the halves of a key, then the first classes
+    // are compared separately from pn, which is free after the sort.
+    const bool wide = static_cast<uint64_t>(n) > UINT32_MAX;
     std::vector<size_t> pn(n);
-    std::vector<size_t> cn(n);
-    for (size_t k = 0, sub_len = 1ull << k; sub_len < n; ++k, sub_len = 1ull << k) {
-        std::vector<size_t> cnt(classes_count);
-        for (size_t i = 0; i < n; ++i) 
-            pn[i] = ((paddr[i] < sub_len) ? n : 0) + paddr[i] - sub_len;
+    std::vector<uint64_t> keys(n);
+    std::vector<size_t> cnt;
+    for (size_t sub_len = 1; sub_len < n && classes_count < n; sub_len <<= 1) {
+        cnt.assign(classes_count, 0);
         for (size_t i = 0; i < n; ++i)
-            ++cnt[classes[pn[i]]];
+            ++cnt[classes[i]]; // pn is a permutation, so its histogram equals one of all positions
         for (size_t i = 1; i < classes_count; ++i)
             cnt[i] += cnt[i - 1];
+        for (size_t i = 0; i < n; ++i)
+            pn[i] = paddr[i] - sub_len + ((paddr[i] < sub_len) ? n : 0);
         for (size_t i = n - 1; i < n; --i)
             paddr[--cnt[classes[pn[i]]]] = pn[i];
-        cn[paddr[0]] = 0;
+        for (size_t i = 0; i < n; ++i) {
+            size_t mid = paddr[i] + sub_len;
+            mid -= (mid >= n) ? n : 0;
+            if (wide) {
+                pn[i] = classes[paddr[i]];
+                keys[i] = classes[mid];
+            } else {
+                keys[i] = (static_cast<uint64_t>(classes[paddr[i]]) << 32) | classes[mid];
+            }
+        }
         classes_count = 1;
+        classes[paddr[0]] = 0;
         for (size_t i = 1; i < n; ++i) {
-            size_t mid1 = (paddr[i] + sub_len) % n;
-            size_t mid2 = (paddr[i - 1] + sub_len) % n;
-            classes_count += (classes[paddr[i]] != classes[paddr[i - 1]] || classes[mid1] != classes[mid2]) ? 1 : 0;
-            cn[paddr[i]] = classes_count - 1;
+            classes_count += (keys[i] != keys[i - 1] || (wide && pn[i] != pn[i - 1])) ? 1 : 0;
+            classes[paddr[i]] = classes_count - 1;
         }
-        std::copy(cn.begin(), cn.end(), classes.begin());
     }
 
     return paddr;
 }
 
-inline size_t bin_search(const std::string& str, const std::string& text, const std::vector<size_t>& suffix_arr) {
+std::vector <size_t> get_suffix_pos(const std::vector<size_t>& suffix_array) {
+    std::vector<size_t> suffix_positions(suffix_array.size());
+    for (size_t i = 0; i < suffix_array.size(); ++i) {
+        suffix_positions[suffix_array[i]] = i;
+    }
+    return suffix_positions;
+}
+
+std::vector<size_t> get_lcp(const std::string& str, const std::vector<size_t>& suffix_array) {
+    const auto n = str.size();
+    std::vector<size_t> result(n);
+    size_t cur = 0;
+    const auto pos = get_suffix_pos(suffix_array);
+    for (size_t i = 0; i < n - 1; ++i) {
+        const auto& posi = pos[i];
+        cur -= (cur > 0) ? 1 : 0;
+        if (posi == n - 1) {
+            result[n - 1] = 0;
+            cur = 0;
+        } else {
+            for (auto j = suffix_array[posi + 1]; std::max(i + cur, j + cur) < n && str[i + cur] == str[j + cur]; ++cur);
+        }
+        result[pos[i]] = cur;
+    }
+    return result;
+}
+
+/*
+  Compare the first str.size() chars of a suffix with str in place, like memcmp
+*/
+inline int compare_prefix(std::string_view text, size_t suffix, std::string_view str) {
+    const auto len = std::min(str.size(), text.size() - suffix);
+    const int cmp = std::memcmp(text.data() + suffix, str.data(), len);
+    return cmp ? cmp : (len < str.size() ? -1 : 0);
+}
+
+/*
+  Range [lo, hi) of suffix array positions of all suffixes starting with str.
+  Search may be narrowed to [from, to) when the answer is known to be inside it.
+*/
+template <typename Index>
+inline std::pair<size_t, size_t> bin_search(std::string_view str, std::string_view text, const Index* suffix_arr,
+                                            size_t from = 0, size_t to = std::string_view::npos) {
+    size_t lo = from;
+    size_t r = std::min(to, text.size());
+    const size_t end = r;
+    while (lo < r) {
+        size_t m = lo + (r - lo) / 2;
+        if (compare_prefix(text, suffix_arr[m], str) < 0) {
+            lo = m + 1;
+        } else {
+            r = m;
+        }
+    }
+    size_t hi = lo;
+    r = end;
+    while (hi < r) {
+        size_t m = hi + (r - hi) / 2;
+        if (compare_prefix(text, suffix_arr[m], str) == 0) {
+            hi = m + 1;
+        } else {
+            r = m;
+        }
+    }
+    return { lo, hi };
+}
+
+/*
+  LCP-LR arrays for Manber-Myers search. For every middle point m of the binary search over (l, r)
+  left[m] = lcp(suffix[l], suffix[m]) and right[m] = lcp(suffix[m], suffix[r]).
+  Values are stored in 32 bits, which is enough as long as patterns are shorter than 4G.
+*/
+struct LcpLr {
+    std::vector<uint32_t> left;
+    std::vector<uint32_t> right;
+};
+
+template <typename Lcp>
+uint32_t fill_lcp_lr(LcpLr& lr, const Lcp* lcp, size_t l, size_t r) {
+    if (r - l <= 1) {
+        return static_cast<uint32_t>(std::min<size_t>(lcp[l], UINT32_MAX));
+    }
+    const size_t m = l + (r - l) / 2;
+    lr.left[m] = fill_lcp_lr(lr, lcp, l, m);
+    lr.right[m] = fill_lcp_lr(lr, lcp, m, r);
+    return std::min(lr.left[m], lr.right[m]);
+}
+
+template <typename Lcp>
+LcpLr get_lcp_lr(const Lcp* lcp, size_t n) {
+    LcpLr lr{ std::vector<uint32_t>(n), std::vector<uint32_t>(n) };
+    if (n > 1) {
+        fill_lcp_lr(lr, lcp, 0, n - 1);
+    }
+    return lr;
+}
+
+/*
+  Manber-Myers search: first suffix array position which is not less (upper=false) or
+  greater (upper=true) than str. Matched prefix lengths of both bounds are kept,
+  so each char of str is compared O(1) times, giving O(m + log n) per query.
+*/
+template <typename Index>
+size_t mlr_bound(std::string_view str, std::string_view text, const Index* suffix_arr, const LcpLr& lr, bool upper) {
+    const size_t n = text.size();
+    const size_t m = str.size();
+    const auto match = [&](size_t suffix, size_t from) {
+        for (; from < m && suffix + from < n && text[suffix + from] == str[from]; ++from);
+        return from;
+    };
+    const auto goes_right = [&](size_t suffix, size_t k) {
+        return k == m ? upper : static_cast<unsigned char>(text[suffix + k]) < static_cast<unsigned char>(str[k]);
+    };
+    size_t r_len = match(suffix_arr[n - 1], 0);
+    if (goes_right(suffix_arr[n - 1], r_len)) {
+        return n;
+    }
+    // suffix_arr[0] is a lone placeholder, which is less than any pattern
     size_t l = 0;
-    size_t r = text.size();
+    size_t r = n - 1;
+    size_t l_len = 0;
     while (r - l > 1) {
-        size_t m = l + (r - l) / 2;
-        const auto substr = text.substr(suffix_arr[m], str.size());
-		l = (substr <= str) ? m : l;
-		r = (substr <= str) ? r : m;
+        const size_t mid = l + (r - l) / 2;
+        size_t k;
+        if (l_len >= r_len) {
+            const size_t mid_len = std::min<size_t>(lr.left[mid], m);
+            if (mid_len > l_len) {
+                l = mid;
+                continue;
+            }
+            if (mid_len < l_len) {
+                r = mid, r_len = mid_len;
+                continue;
+            }
+            k = match(suffix_arr[mid], l_len);
+        } else {
+            const size_t mid_len = std::min<size_t>(lr.right[mid], m);
+            if (mid_len > r_len) {
+                r = mid;
+                continue;
+            }
+            if (mid_len < r_len) {
+                l = mid, l_len = mid_len;
+                continue;
+            }
+            k = match(suffix_arr[mid], r_len);
+        }
+        if (goes_right(suffix_arr[mid], k)) {
+            l = mid, l_len = k;
+        } else {
+            r = mid, r_len = k;
+        }
+    }
+    return r;
+}
+
+template <typename Index>
+inline std::pair<size_t, size_t> mlr_search(std::string_view str, std::string_view text, const Index* suffix_arr, const LcpLr& lr) {
+    return { mlr_bound(str, text, suffix_arr, lr, false), mlr_bound(str, text, suffix_arr, lr, true) };
+}
+
+/*
+  All words are kept in a single buffer to avoid an allocation per word
+*/
+struct WordList {
+    std::string buffer;
+    std::vector<size_t> ends;
+
+    size_t size() const { return ends.size(); }
+    std::string_view operator [] (size_t i) const {
+        const size_t begin = i ? ends[i - 1] : 0;
+        return std::string_view(buffer).substr(begin, ends[i] - begin);
+    }
+};
+
+/*
+  Sweep over a chunk of lexicographically sorted words. Lower bound never decreases along the sweep,
+  and a word is searched only inside the range of the closest previous word which is its prefix.
+*/
+template <typename Index>
+void batch_search_sorted(const WordList& words, const size_t* order, size_t count, std::string_view text,
+                         const Index* suffix_arr, std::pair<size_t, size_t>* ranges) {
+    struct Prefix {
+        size_t length;
+        size_t lo;
+        size_t hi;
+    };
+    std::vector<Prefix> prefixes{ { 0, 0, text.size() } };
+    std::string_view prev;
+    size_t prev_lo = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const auto word = words[order[i]];
+        size_t common = 0;
+        for (; common < std::min(word.size(), prev.size()) && word[common] == prev[common]; ++common);
+        while (prefixes.back().length > common) {
+            prefixes.pop_back();
+        }
+        const auto& outer = prefixes.back();
+        const auto range = bin_search(word, text, suffix_arr, std::max(outer.lo, prev_lo), outer.hi);
+        ranges[order[i]] = range;
+        prefixes.push_back({ word.size(), range.first, range.second });
+        prev = word;
+        prev_lo = range.first;
+    }
+}
+
+/*
+  Answer all words at once: words are sorted and the sorted sequence is split
+  between threads, every thread sweeps its own chunk.
+*/
+template <typename Index>
+std::vector<std::pair<size_t, size_t>> batch_search(const WordList& words, std::string_view text, const Index* suffix_arr, size_t threads_num) {
+    std::vector<size_t> order(words.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return words[a] < words[b]; });
+
+    std::vector<std::pair<size_t, size_t>> ranges(words.size());
+    threads_num = std::max<size_t>(1, std::min(threads_num, order.size() / MIN_WORDS_PER_THREAD));
+    const size_t chunk = (order.size() + threads_num - 1) / threads_num;
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < threads_num; ++t) {
+        const size_t begin = std::min(order.size(), t * chunk);
+        const size_t count = std::min(order.size() - begin, chunk);
+        threads.emplace_back(batch_search_sorted<Index>, std::cref(words), order.data() + begin, count, text, suffix_arr, ranges.data());
+    }
+    batch_search_sorted(words, order.data(), std::min(order.size(), chunk), text, suffix_arr, ranges.data());
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return ranges;
+}
+
+/*
+  Suffix array of a growing text, organized like an LSM tree. Every append becomes an immutable segment
+  with a suffix array of the segment text only; segments not larger than the new one are merged into it
+  by rebuilding, so sizes grow geometrically from the newest segment to the oldest. There are O(log n)
+  segments and every char is rebuilt O(log n) times, an append costs amortized O(log^2 n) per char.
+  A word is searched in every segment, which finds occurrences lying inside segments; occurrences
+  crossing a segment end are found by scanning 2 * |word| chars around it.
+*/
+class DynamicSuffixArray {
+public:
+    // false if chunk has chars out of a..z, they would index past the char counters of get_suffix_array
+    bool append(std::string_view chunk) {
+        if (!std::all_of(chunk.begin(), chunk.end(), [](char ch) { return FIRST_LETTER <= ch && ch <= 'z'; })) {
+            return false;
+        }
+        if (chunk.empty()) {
+            return true;
+        }
+        text += chunk;
+        size_t begin = text.size() - chunk.size();
+        while (!segments.empty() && segments.back().size() <= text.size() - begin) {
+            begin = segments.back().begin;
+            segments.pop_back();
+        }
+        segments.push_back(build_segment(begin, text.size()));
+        return true;
+    }
+
+    size_t count(std::string_view word) const {
+        size_t result = 0;
+        for (const auto& segment : segments) {
+            const auto segment_text = std::string_view(text).substr(segment.begin, segment.size());
+            const auto [lo, hi] = bin_search(word, segment_text, segment.suffix_array.data());
+            result += hi - lo + crossing_count(word, segment);
+        }
+        return result;
+    }
+
+    size_t size() const { return text.size(); }
+    size_t segments_count() const { return segments.size(); }
+
+private:
+    struct Segment {
+        size_t begin;
+        size_t end;
+        std::vector<size_t> suffix_array; // positions relative to begin, without placeholder
+
+        size_t size() const { return end - begin; }
+    };
+
+    Segment build_segment(size_t begin, size_t end) const {
+        std::string str(text, begin, end - begin);
+        str += PLACEHOLDER;
+        auto suffix_arr = get_suffix_array(str);
+        suffix_arr.erase(suffix_arr.begin()); // placeholder suffix is always the first one
+        return { begin, end, std::move(suffix_arr) };
+    }
+
+    // occurrences starting inside the segment and ending after it
+    size_t crossing_count(std::string_view word, const Segment& segment) const {
+        if (word.size() < 2 || segment.end == text.size()) {
+            return 0;
+        }
+        const auto from = segment.end - std::min(segment.size(), word.size() - 1);
+        const auto window = std::string_view(text).substr(from, word.size() - 1 + segment.end - from);
+        size_t result = 0;
+        for (auto pos = window.find(word); pos != std::string_view::npos && from + pos < segment.end; pos = window.find(word, pos + 1)) {
+            ++result;
+        }
+        return result;
+    }
+
+    std::string text;
+    std::vector<Segment> segments;
+};
+
+inline void print_answer(FastWriter& out, size_t lo, size_t hi, bool print_count) {
+    if (print_count) {
+        out << hi - lo << '\n';
+    } else {
+        out << (lo < hi ? "YES\n" : "NO\n");
     }
-    return l;
 }
 
-int main() {
+template <typename Index>
+void solve_multiple_search(FastWriter& out, const WordList& words, std::string_view text, const Index* suffix_arr, const LcpLr* lr, bool print_count) {
+    for (size_t i = 0; i < words.size(); ++i) {
+        const auto [lo, hi] = lr ? mlr_search(words[i], text, suffix_arr, *lr) : bin_search(words[i], text, suffix_arr);
+        print_answer(out, lo, hi, print_count);
+    }
+}
+
+template <typename Index>
+void solve_batch_search(FastWriter& out, const WordList& words, std::string_view text, const Index* suffix_arr, size_t threads_num, bool print_count) {
+    for (const auto& [lo, hi] : batch_search(words, text, suffix_arr, threads_num)) {
+        print_answer(out, lo, hi, print_count);
+    }
+}
+
+void solve_fm_search(FastWriter& out, const WordList& words, const FmIndex& fm, bool print_count, bool print_positions) {
+    std::vector<size_t> positions;
+    for (size_t i = 0; i < words.size(); ++i) {
+        const auto [lo, hi] = fm.search(words[i]);
+        if (!print_positions) {
+            print_answer(out, lo, hi, print_count);
+            continue;
+        }
+        positions.clear();
+        for (size_t j = lo; j < hi; ++j) {
+            positions.push_back(fm.locate(j));
+        }
+        std::sort(positions.begin(), positions.end());
+        out << positions.size();
+        for (const auto pos : positions) {
+            out << ' ' << pos + 1;
+        }
+        out << '\n';
+    }
+}
+
+/*
+  Lines "+ chunk" append chunk to the text, lines "? word" are answered on the text appended so far.
+  Lines are read as they come, answers are flushed as soon as no more input is waiting.
+  Letters are lowercased, a chunk with other chars is reported and skipped.
+*/
+void solve_dynamic_search(LineReader& in, FastWriter& out, bool print_count) {
+    DynamicSuffixArray index;
+    std::string line;
+    const size_t w_start = 2;
+    while (in.getline(line)) {
+        if (line.empty()) {
+            continue;
+        }
+        std::transform(line.begin(), line.end(), line.begin(), [](char ch) { return ('A' <= ch && ch <= 'Z') ? ch - 'A' + 'a' : ch; });
+        const auto arg = std::string_view(line).substr(std::min(w_start, line.size()));
+        if (line[0] == '+') {
+            if (!index.append(arg)) {
+                std::cerr << "Skipped chunk with chars other than latin letters: " << arg << "\n";
+            }
+        } else if (line[0] == '?') {
+            const auto count = index.count(arg);
+            print_answer(out, 0, count, print_count);
+            if (!in.has_pending_input()) {
+                out.flush();
+            }
+        }
+    }
+}
+
+WordList read_words(FastReader& in) {
+    size_t n = 0;
+    in.read(n);
+    WordList words;
+    words.ends.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        words.buffer += in.token();
+        words.ends.push_back(words.buffer.size());
+    }
+    return words;
+}
+
+/*
+  Usage:
+    app                                  n, patterns and text from stdin
+    app --build-index FILE [--with-lcp]  text from stdin, suffix array index is saved to FILE
+    app --index FILE [--verify]          n and patterns from stdin, text and suffix array are mapped from FILE
+    --count                              print number of occurrences of every pattern instead of YES/NO
+    --mlr                                use LCP-accelerated search, index must be built --with-lcp
+    --batch [--threads N]                sort all patterns and answer them in a single sweep over N threads
+    --fm [--locate]                      answer from a compressed FM-index, --locate prints 1-based positions of all occurrences
+                                         --mlr, --batch and --fm exclude each other
+    app --dynamic                        lines "+ chunk" append to the text, lines "? word" are answered immediately
+*/
+int main(int argc, char* argv[]) {
 #ifdef _DEBUG
     std::ifstream input_stream("input.txt");
     std::cin.rdbuf(input_stream.rdbuf());
 #endif
     std::ios::sync_with_stdio(false), std::cin.tie(0), std::cout.tie(0);
 
-    size_t n;
-    std::cin >> n;
+    const std::vector<std::string> args(argv + 1, argv + argc);
+    const bool print_count = has_flag(args, "--count");
+    const bool use_mlr = has_flag(args, "--mlr");
+    const bool use_batch = has_flag(args, "--batch");
+    const bool use_fm = has_flag(args, "--fm");
+    const auto threads_num = get_threads_num(args);
+    if (!threads_num) {
+        std::cerr << THREADS_ERROR << "\n";
+        return EXIT_FAILURE;
+    }
+    if (use_mlr + use_batch + use_fm > 1) {
+        std::cerr << "--mlr, --batch and --fm are different search modes, choose one\n";
+        return EXIT_FAILURE;
+    }
+    const IndexAlphabet alphabet{ FIRST_LETTER, PLACEHOLDER, static_cast<uint16_t>(VOC_SIZE) };
+    FastWriter out(std::cout);
 
-    std::vector<std::string> strs(n);
-    for (auto& s : strs) {
-        std::cin >> s;
+    if (has_flag(args, "--dynamic")) {
+        LineReader in(std::cin);
+        solve_dynamic_search(in, out, print_count);
+        return EXIT_SUCCESS;
     }
 
+    FastReader in(std::cin);
+
+    if (args.size() >= 2 && args[0] == "--build-index") {
+        std::string text;
+        in.read(text);
+        text += PLACEHOLDER;
+        const auto suffix_arr = get_suffix_array(text);
+        if (has_flag(args, "--with-lcp")) {
+            const auto lcp = get_lcp(text, suffix_arr);
+            SuffixIndex::write(args[1], text, suffix_arr, &lcp, alphabet);
+        } else {
+            SuffixIndex::write(args[1], text, suffix_arr, nullptr, alphabet);
+        }
+        return EXIT_SUCCESS;
+    }
+
+    if (args.size() >= 2 && args[0] == "--index") {
+        try {
+            const auto index = SuffixIndex::load(args[1], alphabet, has_flag(args, "--verify"));
+            if (use_mlr && !index.has_lcp()) {
+                throw SuffixIndexException(args[1], "Index has no lcp, rebuild it --with-lcp");
+            }
+            if (use_batch) {
+                solve_batch_search(out, read_words(in), index.text(), index.suffix_array(), *threads_num, print_count);
+                return EXIT_SUCCESS;
+            }
+            if (use_fm) {
+                const FmIndex fm(index.text(), index.suffix_array(), PLACEHOLDER, VOC_SIZE);
+                solve_fm_search(out, read_words(in), fm, print_count, has_flag(args, "--locate"));
+                return EXIT_SUCCESS;
+            }
+            const auto lr = use_mlr ? get_lcp_lr(index.lcp(), index.size()) : LcpLr();
+            solve_multiple_search(out, read_words(in), index.text(), index.suffix_array(), use_mlr ? &lr : nullptr, print_count);
+        } catch (const SuffixIndexException& e) {
+            std::cerr << e.what() << "\n";
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    const auto words = read_words(in);
     std::string text;
-    std::cin >> text;
+    in.read(text);
     text += PLACEHOLDER;
 
+    if (use_fm) {
+        const auto fm = [&]() {
+            const auto suffix_arr = get_suffix_array(text);
+            return FmIndex(text, suffix_arr.data(), PLACEHOLDER, VOC_SIZE);
+        }();
+        std::string().swap(text);
+        solve_fm_search(out, words, fm, print_count, has_flag(args, "--locate"));
+        return EXIT_SUCCESS;
+    }
+
     const auto suffix_arr = get_suffix_array(text);
-    for (const auto& str : strs) {
-        const size_t pos = bin_search(str, text, suffix_arr);
-        std::cout << (text.substr(suffix_arr[pos], str.size()) == str ? "YES" : "NO") << "\n";
+    if (use_batch) {
+        solve_batch_search(out, words, text, suffix_arr.data(), *threads_num, print_count);
+        return EXIT_SUCCESS;
     }
+    const auto lr = use_mlr ? get_lcp_lr(get_lcp(text, suffix_arr).data(), text.size()) : LcpLr();
+    solve_multiple_search(out, words, text, suffix_arr.data(), use_mlr ? &lr : nullptr, print_count);
 
     return EXIT_SUCCESS;
 }
\ No newline at end of file
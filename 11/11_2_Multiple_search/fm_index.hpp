@@ -0,0 +1,227 @@
+#pragma once
+#ifndef FM_INDEX_HPP
+#define FM_INDEX_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+inline size_t popcount64(uint64_t x) { return __popcnt64(x); }
+#else
+inline size_t popcount64(uint64_t x) { return __builtin_popcountll(x); }
+#endif
+
+/*
+  Bit vector with constant time rank. Every 512 bits (a cache line of words) store
+  the number of set bits before them, the rest is counted with popcount.
+*/
+class BitVector {
+public:
+    BitVector() = default;
+    explicit BitVector(size_t n) : words((n + 63) / 64 + 1) {}
+
+    void set(size_t i) { words[i / 64] |= uint64_t(1) << (i % 64); }
+    bool get(size_t i) const { return (words[i / 64] >> (i % 64)) & 1; }
+
+    void build_rank() {
+        blocks.resize(words.size() / WORDS_PER_BLOCK + 1);
+        size_t count = 0;
+        for (size_t i = 0; i < words.size(); ++i) {
+            if (i % WORDS_PER_BLOCK == 0) {
+                blocks[i / WORDS_PER_BLOCK] = count;
+            }
+            count += popcount64(words[i]);
+        }
+    }
+
+    // number of set bits in [0, i)
+    size_t rank1(size_t i) const {
+        const size_t word = i / 64;
+        size_t count = blocks[word / WORDS_PER_BLOCK];
+        for (size_t w = word - word % WORDS_PER_BLOCK; w < word; ++w) {
+            count += popcount64(words[w]);
+        }
+        const auto tail = i % 64;
+        return count + (tail ? popcount64(words[word] << (64 - tail)) : 0);
+    }
+    size_t rank0(size_t i) const { return i - rank1(i); }
+
+    size_t bytes() const { return (words.size() + blocks.size()) * sizeof(uint64_t); }
+
+private:
+    static const size_t WORDS_PER_BLOCK = 8;
+    std::vector<uint64_t> words;
+    std::vector<uint64_t> blocks;
+};
+
+/*
+  Wavelet matrix over symbols [0, 2^levels): sequence is stored as one bit vector per bit of symbol,
+  on each level symbols are stably partitioned by the current bit (zeros first).
+  rank and access cost O(levels).
+*/
+class WaveletMatrix {
+public:
+    WaveletMatrix() = default;
+    WaveletMatrix(std::vector<uint8_t> seq, size_t _levels) : levels(_levels), zeros(_levels), bits(_levels) {
+        std::vector<uint8_t> next(seq.size());
+        for (size_t l = 0; l < levels; ++l) {
+            const auto shift = levels - 1 - l;
+            bits[l] = BitVector(seq.size());
+            size_t zeros_pos = 0;
+            for (size_t i = 0; i < seq.size(); ++i) {
+                if ((seq[i] >> shift) & 1) {
+                    bits[l].set(i);
+                } else {
+                    next[zeros_pos++] = seq[i];
+                }
+            }
+            zeros[l] = zeros_pos;
+            for (size_t i = 0; i < seq.size(); ++i) {
+                if ((seq[i] >> shift) & 1) {
+                    next[zeros_pos++] = seq[i];
+                }
+            }
+            bits[l].build_rank();
+            std::swap(seq, next);
+        }
+    }
+
+    // number of c symbols in [0, i)
+    size_t rank(uint8_t c, size_t i) const {
+        size_t s = 0;
+        for (size_t l = 0; l < levels; ++l) {
+            if ((c >> (levels - 1 - l)) & 1) {
+                s = zeros[l] + bits[l].rank1(s);
+                i = zeros[l] + bits[l].rank1(i);
+            } else {
+                s = bits[l].rank0(s);
+                i = bits[l].rank0(i);
+            }
+        }
+        return i - s;
+    }
+
+    // symbol at position i together with its rank, which is what LF mapping needs
+    std::pair<uint8_t, size_t> access_rank(size_t i) const {
+        uint8_t c = 0;
+        size_t s = 0;
+        for (size_t l = 0; l < levels; ++l) {
+            const bool bit = bits[l].get(i);
+            c = static_cast<uint8_t>((c << 1) | (bit ? 1 : 0));
+            if (bit) {
+                s = zeros[l] + bits[l].rank1(s);
+                i = zeros[l] + bits[l].rank1(i);
+            } else {
+                s = bits[l].rank0(s);
+                i = bits[l].rank0(i);
+            }
+        }
+        return { c, i - s };
+    }
+
+    size_t bytes() const {
+        size_t result = zeros.size() * sizeof(size_t);
+        for (const auto& level : bits) {
+            result += level.bytes();
+        }
+        return result;
+    }
+
+private:
+    size_t levels = 0;
+    std::vector<size_t> zeros;
+    std::vector<BitVector> bits;
+};
+
+/*
+  FM-index: BWT of the text kept in a wavelet matrix, plus every SA_SAMPLE-th text position
+  of the suffix array for locate. Neither text nor full suffix array are kept.
+*/
+class FmIndex {
+public:
+    static const size_t SA_SAMPLE = 32;
+
+    /*
+      text must end with a unique smallest placeholder, symbols are mapped to [0, voc_size)
+      by subtracting placeholder
+    */
+    template <typename Index>
+    FmIndex(std::string_view text, const Index* suffix_arr, char _placeholder, size_t voc_size)
+        : n(text.size()), placeholder(_placeholder), counts(voc_size + 1) {
+        size_t levels = 1;
+        for (; (size_t(1) << levels) < voc_size; ++levels);
+        std::vector<uint8_t> bwt(n);
+        sampled = BitVector(n);
+        for (size_t i = 0; i < n; ++i) {
+            const size_t pos = suffix_arr[i];
+            bwt[i] = symbol(text[pos ? pos - 1 : n - 1]);
+            ++counts[symbol(text[i]) + 1];
+            if (pos % SA_SAMPLE == 0) {
+                sampled.set(i);
+                samples.push_back(pos);
+            }
+        }
+        for (size_t c = 1; c < counts.size(); ++c) {
+            counts[c] += counts[c - 1];
+        }
+        sampled.build_rank();
+        bwt_matrix = WaveletMatrix(std::move(bwt), levels);
+    }
+
+    /*
+      Range [lo, hi) of suffix array positions of all suffixes starting with str (backward search)
+    */
+    std::pair<size_t, size_t> search(std::string_view str) const {
+        size_t lo = 0;
+        size_t hi = n;
+        for (size_t i = str.size(); i-- > 0 && lo < hi;) {
+            const auto c = symbol(str[i]);
+            if (c == 0 || static_cast<size_t>(c) + 1 >= counts.size()) {
+                return { 0, 0 };
+            }
+            lo = counts[c] + bwt_matrix.rank(c, lo);
+            hi = counts[c] + bwt_matrix.rank(c, hi);
+        }
+        return { lo, hi };
+    }
+
+    size_t count(std::string_view str) const {
+        const auto [lo, hi] = search(str);
+        return hi > lo ? hi - lo : 0;
+    }
+
+    /*
+      Text position of the suffix at suffix array position i: walk LF until a sampled position
+    */
+    size_t locate(size_t i) const {
+        size_t steps = 0;
+        while (!sampled.get(i)) {
+            const auto [c, rank] = bwt_matrix.access_rank(i);
+            i = counts[c] + rank;
+            ++steps;
+        }
+        return (samples[sampled.rank1(i)] + steps) % n;
+    }
+
+    size_t size() const { return n; }
+
+    size_t bytes() const {
+        return bwt_matrix.bytes() + sampled.bytes() + samples.size() * sizeof(size_t) + counts.size() * sizeof(size_t);
+    }
+
+private:
+    uint8_t symbol(char ch) const { return static_cast<uint8_t>(ch - placeholder); }
+
+    size_t n;
+    char placeholder;
+    std::vector<size_t> counts; // counts[c] - number of symbols less than c
+    WaveletMatrix bwt_matrix;
+    BitVector sampled;
+    std::vector<size_t> samples;
+};
+
+#endif // !FM_INDEX_HPP
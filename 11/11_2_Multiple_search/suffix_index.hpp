@@ -0,0 +1,257 @@
+#pragma once
+#ifndef SUFFIX_INDEX_HPP
+#define SUFFIX_INDEX_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // !_WIN32
+
+/*
+  Persistent suffix array index.
+  The file is written once and then memory mapped read-only, so opening an index costs
+  a couple of syscalls instead of a full get_suffix_array run.
+
+  Layout (native byte order, every section starts at an 8-byte boundary):
+    IndexHeader
+    text            header.text_size bytes, including the trailing placeholder
+    suffix array    header.text_size uint64_t values
+    lcp             header.text_size uint64_t values, present only with INDEX_HAS_LCP flag
+*/
+
+class SuffixIndexException : public std::exception {
+public:
+    explicit SuffixIndexException(const std::string& _path, const std::string& _msg) noexcept : std::exception() {
+        std::stringstream ss;
+        ss << _msg << "\nIndex: " << _path;
+        msg = ss.str();
+    }
+    const char* what() const noexcept override {
+        return msg.c_str();
+    }
+private:
+    std::string msg;
+};
+
+struct IndexAlphabet {
+    char first_letter;
+    char placeholder;
+    uint16_t voc_size;
+    bool operator == (const IndexAlphabet& rhs) const {
+        return first_letter == rhs.first_letter && placeholder == rhs.placeholder && voc_size == rhs.voc_size;
+    }
+};
+
+static const uint32_t INDEX_VERSION = 2;
+static const uint32_t INDEX_HAS_LCP = 1u << 0;
+static const char INDEX_MAGIC[8] = { 'S', 'U', 'F', 'I', 'D', 'X', '\0', '\1' };
+
+struct IndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t text_size;
+    IndexAlphabet alphabet;
+    uint32_t reserved;
+    uint64_t text_offset;
+    uint64_t sa_offset;
+    uint64_t lcp_offset;
+    uint64_t file_size;
+    uint64_t checksum; // FNV-1a over the whole file with this field zeroed
+};
+
+class SuffixIndex {
+public:
+    SuffixIndex(const SuffixIndex&) = delete;
+    SuffixIndex& operator = (const SuffixIndex&) = delete;
+    SuffixIndex(SuffixIndex&& rhs) noexcept { *this = std::move(rhs); }
+    SuffixIndex& operator = (SuffixIndex&& rhs) noexcept {
+        std::swap(data, rhs.data);
+        std::swap(data_size, rhs.data_size);
+        std::swap(buffer, rhs.buffer);
+        return *this;
+    }
+    ~SuffixIndex() {
+#ifndef _WIN32
+        if (data && buffer.empty()) {
+            munmap(const_cast<char*>(data), data_size);
+        }
+#endif // !_WIN32
+    }
+
+    /*
+      Serialize text (with its trailing placeholder), suffix array and optionally lcp array
+    */
+    static void write(const std::string& path, const std::string& text, const std::vector<size_t>& suffix_array,
+                      const std::vector<size_t>* lcp, IndexAlphabet alphabet) {
+        const uint64_t n = text.size();
+        IndexHeader header{};
+        std::memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+        header.version = INDEX_VERSION;
+        header.flags = lcp ? INDEX_HAS_LCP : 0;
+        header.text_size = n;
+        header.alphabet = alphabet;
+        set_layout(header);
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw SuffixIndexException(path, "Cannot open index for writing");
+        }
+        uint64_t checksum = fnv1a(FNV_OFFSET, reinterpret_cast<const char*>(&header), sizeof(header));
+        const auto put = [&](const void* src, size_t size) {
+            out.write(static_cast<const char*>(src), size);
+            checksum = fnv1a(checksum, static_cast<const char*>(src), size);
+        };
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        put(text.data(), text.size());
+        const char padding[8] = { 0 };
+        put(padding, header.sa_offset - header.text_offset - n);
+        put_array(put, suffix_array);
+        if (lcp) {
+            put_array(put, *lcp);
+        }
+        header.checksum = checksum;
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (!out) {
+            throw SuffixIndexException(path, "Failed to write index");
+        }
+    }
+
+    /*
+      Map an index into memory. Checksum verification touches every page of the file,
+      so it is optional and meant for a first open after copying an index around.
+    */
+    static SuffixIndex load(const std::string& path, IndexAlphabet alphabet, bool verify = false) {
+        SuffixIndex index;
+        index.map(path);
+        if (index.data_size < sizeof(IndexHeader)) {
+            throw SuffixIndexException(path, "File is too small to be an index");
+        }
+        const auto& header = index.header();
+        if (std::memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 || header.version != INDEX_VERSION) {
+            throw SuffixIndexException(path, "Unknown index format");
+        }
+        if ((header.flags & ~INDEX_HAS_LCP) != 0) {
+            throw SuffixIndexException(path, "Unknown index flags");
+        }
+        // sections must be exactly where write puts them, otherwise a damaged header sends readers out of the file
+        if (header.text_size > index.data_size / sizeof(uint64_t)) {
+            throw SuffixIndexException(path, "Index is truncated or its header is damaged");
+        }
+        IndexHeader expected = header;
+        set_layout(expected);
+        if (expected.file_size != index.data_size || header.file_size != index.data_size || header.text_offset != expected.text_offset
+            || header.sa_offset != expected.sa_offset || header.lcp_offset != expected.lcp_offset) {
+            throw SuffixIndexException(path, "Index is truncated or its header is damaged");
+        }
+        if (!(header.alphabet == alphabet)) {
+            throw SuffixIndexException(path, "Index was built for another alphabet");
+        }
+        if (verify) {
+            IndexHeader unsigned_header = header;
+            unsigned_header.checksum = 0;
+            const auto checksum = fnv1a(FNV_OFFSET, reinterpret_cast<const char*>(&unsigned_header), sizeof(IndexHeader));
+            const auto payload = index.data + sizeof(IndexHeader);
+            if (fnv1a(checksum, payload, index.data_size - sizeof(IndexHeader)) != header.checksum) {
+                throw SuffixIndexException(path, "Index checksum mismatch");
+            }
+        }
+        return index;
+    }
+
+    size_t size() const { return header().text_size; }
+    bool has_lcp() const { return header().flags & INDEX_HAS_LCP; }
+    std::string_view text() const { return { data + header().text_offset, size() }; }
+    const uint64_t* suffix_array() const { return reinterpret_cast<const uint64_t*>(data + header().sa_offset); }
+    const uint64_t* lcp() const { return has_lcp() ? reinterpret_cast<const uint64_t*>(data + header().lcp_offset) : nullptr; }
+
+private:
+    SuffixIndex() = default;
+
+    static const uint64_t FNV_OFFSET = 14695981039346656037ull;
+    static const uint64_t FNV_PRIME = 1099511628211ull;
+
+    static uint64_t fnv1a(uint64_t hash, const char* src, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ static_cast<unsigned char>(src[i])) * FNV_PRIME;
+        }
+        return hash;
+    }
+
+    static uint64_t align(uint64_t offset) {
+        return (offset + 7) & ~uint64_t(7);
+    }
+
+    // section offsets and file size for text_size and flags of a header
+    static void set_layout(IndexHeader& header) {
+        const uint64_t n = header.text_size;
+        const bool with_lcp = header.flags & INDEX_HAS_LCP;
+        header.text_offset = sizeof(IndexHeader);
+        header.sa_offset = align(header.text_offset + n);
+        header.lcp_offset = with_lcp ? header.sa_offset + n * sizeof(uint64_t) : 0;
+        header.file_size = (with_lcp ? header.lcp_offset : header.sa_offset) + n * sizeof(uint64_t);
+    }
+
+    template <typename Put>
+    static void put_array(Put& put, const std::vector<size_t>& arr) {
+        // size_t may be 32-bit, index always stores 64-bit values
+        static const size_t CHUNK = 1 << 16;
+        std::vector<uint64_t> chunk(std::min(CHUNK, arr.size()));
+        for (size_t i = 0; i < arr.size(); i += CHUNK) {
+            const auto count = std::min(CHUNK, arr.size() - i);
+            std::copy(arr.begin() + i, arr.begin() + i + count, chunk.begin());
+            put(chunk.data(), count * sizeof(uint64_t));
+        }
+    }
+
+    const IndexHeader& header() const { return *reinterpret_cast<const IndexHeader*>(data); }
+
+    void map(const std::string& path) {
+#ifndef _WIN32
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw SuffixIndexException(path, "Cannot open index");
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            throw SuffixIndexException(path, "Cannot stat index");
+        }
+        void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) {
+            throw SuffixIndexException(path, "Cannot map index");
+        }
+        data = static_cast<const char*>(mapped);
+        data_size = st.st_size;
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) {
+            throw SuffixIndexException(path, "Cannot open index");
+        }
+        data_size = static_cast<size_t>(in.tellg());
+        buffer.resize((data_size + 7) / 8);
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(buffer.data()), data_size);
+        data = reinterpret_cast<const char*>(buffer.data());
+#endif // !_WIN32
+    }
+
+    const char* data = nullptr;
+    size_t data_size = 0;
+    std::vector<uint64_t> buffer; // used instead of a mapping where mmap is not available
+};
+
+#endif // !SUFFIX_INDEX_HPP
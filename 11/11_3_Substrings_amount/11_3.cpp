@@ -20,14 +20,20 @@ ababb
 */
 
 #include <iostream>
+#include <cstdint>
 #include <fstream>
 #include <vector>
 #include <string>
 #include <algorithm>
 
+#include "../../common/fast_io.hpp"
+#include "../../common/compressed_lcp.hpp"
+#include "external_count.hpp"
+
 static const char FIRST_LETTER = 'a';
 static const char PLACEHOLDER = FIRST_LETTER - 1;
 static const size_t VOC_SIZE = 'z' - PLACEHOLDER + 1;
+static const size_t IN_MEMORY_BYTES_PER_CHAR = 48; // text, suffix array, its construction buffers and lcp
 
 size_t inline char_addr(char ch) {
     return ch - PLACEHOLDER;
@@ -49,33 +55,46 @@ std::vector<size_t> get_suffix_array(const std::string& str) {
     size_t classes_count = 1;
     std::vector<size_t> classes(n);
     classes[paddr[0]] = 0;
-    for (int i = 1; i < n; ++i) {
+    for (size_t i = 1; i < n; ++i) {
         classes_count += (str[paddr[i]] != str[paddr[i - 1]]) ? 1 : 0;
         classes[paddr[i]] = classes_count - 1;
     }
 
-    // Sort pairs
+    // Sort pairs. Pass stops as soon as all classes are distinct.
+    // Class pairs are packed into a single word, so renumbering is a linear scan over keys,
+    // and modular indexing is done with conditional adds instead of branches and divisions.
+    // Classes of a text longer than 2^32 don't fit the halves of a key, then the first classes
+    // are compared separately from pn, which is free after the sort.
+    const bool wide = static_cast<uint64_t>(n) > UINT32_MAX;
     std::vector<size_t> pn(n);
-    std::vector<size_t> cn(n);
-    for (size_t k = 0, sub_len = 1ull << k; sub_len < n; ++k, sub_len = 1ull << k) {
-        std::vector<size_t> cnt(classes_count);
-        for (size_t i = 0; i < n; ++i) 
-            pn[i] = ((paddr[i] < sub_len) ? n : 0) + paddr[i] - sub_len;
+    std::vector<uint64_t> keys(n);
+    std::vector<size_t> cnt;
+    for (size_t sub_len = 1; sub_len < n && classes_count < n; sub_len <<= 1) {
+        cnt.assign(classes_count, 0);
         for (size_t i = 0; i < n; ++i)
-            ++cnt[classes[pn[i]]];
+            ++cnt[classes[i]]; // pn is a permutation, so its histogram equals one of all positions
         for (size_t i = 1; i < classes_count; ++i)
             cnt[i] += cnt[i - 1];
+        for (size_t i = 0; i < n; ++i)
+            pn[i] = paddr[i] - sub_len + ((paddr[i] < sub_len) ? n : 0);
         for (size_t i = n - 1; i < n; --i)
             paddr[--cnt[classes[pn[i]]]] = pn[i];
-        cn[paddr[0]] = 0;
+        for (size_t i = 0; i < n; ++i) {
+            size_t mid = paddr[i] + sub_len;
+            mid -= (mid >= n) ? n : 0;
+            if (wide) {
+                pn[i] = classes[paddr[i]];
+                keys[i] = classes[mid];
+            } else {
+                keys[i] = (static_cast<uint64_t>(classes[paddr[i]]) << 32) | classes[mid];
+            }
+        }
         classes_count = 1;
+        classes[paddr[0]] = 0;
         for (size_t i = 1; i < n; ++i) {
-            size_t mid1 = (paddr[i] + sub_len) % n;
-            size_t mid2 = (paddr[i - 1] + sub_len) % n;
-            classes_count += (classes[paddr[i]] != classes[paddr[i - 1]] || classes[mid1] != classes[mid2]) ? 1 : 0;
-            cn[paddr[i]] = classes_count - 1;
+            classes_count += (keys[i] != keys[i - 1] || (wide && pn[i] != pn[i - 1])) ? 1 : 0;
+            classes[paddr[i]] = classes_count - 1;
         }
-        std::copy(cn.begin(), cn.end(), classes.begin());
     }
 
     return paddr;
@@ -89,46 +108,80 @@ std::vector <size_t> get_suffix_pos(const std::vector<size_t>& suffix_array) {
     return suffix_positions;
 }
 
-std::vector<size_t> get_lcp(const std::string& str, const std::vector<size_t>& suffix_array) {
+CompressedLcp get_lcp(const std::string& str, const std::vector<size_t>& suffix_array) {
     const auto n = str.size();
-    std::vector<size_t> result(n);
+    CompressedLcp result(n);
     size_t cur = 0;
     const auto pos = get_suffix_pos(suffix_array);
     for (size_t i = 0; i < n - 1; ++i) {
         const auto& posi = pos[i];
         cur -= (cur > 0) ? 1 : 0;
         if (posi == n - 1) {
-            result[n - 1] = 0;
+            result.set(n - 1, 0);
             cur = 0;
         } else {
             for (auto j = suffix_array[posi + 1]; std::max(i + cur, j + cur) < n && str[i + cur] == str[j + cur]; ++cur);
         }
-        result[pos[i]] = cur;
+        result.set(pos[i], cur);
     }
+    result.finish();
     return result;
 }
 
-int main() {
+// every suffix adds its length minus the part shared with the previous one
+UInt128 count_substrings(std::string str) {
+    str += PLACEHOLDER;
+    const auto suffix_array = get_suffix_array(str);
+    const auto lcp = get_lcp(str, suffix_array);
+    const auto str_size = str.size() - 1;
+    UInt128 sub_sum;
+    CompressedLcp::Scanner lcp_scan(lcp);
+    for (size_t i = 1; i < suffix_array.size(); ++i) {
+        sub_sum += (str_size - suffix_array[i]) - lcp_scan[i - 1];
+    }
+    return sub_sum;
+}
+
+/*
+  Usage:
+    app                                 string from stdin
+    app --external FILE [--memory MB]   string is mapped from FILE and never loaded into memory as a whole,
+                                        suffix positions take at most MB megabytes (1024 by default),
+                                        a text small enough for the budget is counted in memory
+*/
+int main(int argc, char* argv[]) {
 #ifdef _DEBUG
     std::ifstream input_stream("input.txt");
     std::cin.rdbuf(input_stream.rdbuf());
 #endif
     std::ios::sync_with_stdio(false), std::cin.tie(0), std::cout.tie(0);
 
-    std::string str;
-    std::cin >> str;
-    str += PLACEHOLDER;
-
-    const auto suffix_array = get_suffix_array(str);
-    const auto lcp = get_lcp(str, suffix_array);
-
-    int64_t sub_sum = str.size() - 1;
-    sub_sum = (sub_sum * (sub_sum + 1)) / 2;
-
-    for (size_t i = 0; i < lcp.size() - 1; ++i) {
-        sub_sum -= lcp[i];
+    const std::vector<std::string> args(argv + 1, argv + argc);
+    if (args.size() >= 2 && args[0] == "--external") {
+        size_t memory_mb = 1024;
+        if (args.size() >= 4 && args[2] == "--memory") {
+            memory_mb = std::stoul(args[3]);
+        }
+        try {
+            const MappedText text(args[1]);
+            ExternalSubstringCounter counter(text.view(), FIRST_LETTER, VOC_SIZE, memory_mb << 20);
+            // suffix array is not slowed down by long repeats, unlike direct comparisons of suffixes
+            if (counter.length() <= (memory_mb << 20) / IN_MEMORY_BYTES_PER_CHAR) {
+                std::cout << count_substrings(std::string(text.view().substr(0, counter.length()))).to_string();
+            } else {
+                std::cout << counter.count().to_string();
+            }
+        } catch (const MappedTextException& e) {
+            std::cerr << e.what() << "\n";
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
     }
-    std::cout << sub_sum;
+
+    FastReader in(std::cin);
+    std::string str;
+    in.read(str);
+    std::cout << count_substrings(std::move(str)).to_string();
 
     return EXIT_SUCCESS;
 }
\ No newline at end of file
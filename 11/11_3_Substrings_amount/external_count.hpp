@@ -0,0 +1,337 @@
+#pragma once
+#ifndef EXTERNAL_COUNT_HPP
+#define EXTERNAL_COUNT_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <limits>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // !_WIN32
+
+/*
+  Unsigned 128-bit accumulator: amount of substrings is about n^2 / 2,
+  which does not fit into 64 bits for n beyond 6 * 10^9
+*/
+struct UInt128 {
+    uint64_t hi = 0;
+    uint64_t lo = 0;
+
+    UInt128& operator += (uint64_t value) {
+        lo += value;
+        hi += (lo < value) ? 1 : 0;
+        return *this;
+    }
+
+    std::string to_string() const {
+        uint32_t limbs[4] = { static_cast<uint32_t>(hi >> 32), static_cast<uint32_t>(hi), static_cast<uint32_t>(lo >> 32), static_cast<uint32_t>(lo) };
+        std::string digits;
+        do {
+            uint64_t rest = 0;
+            for (auto& limb : limbs) {
+                const uint64_t cur = (rest << 32) | limb;
+                limb = static_cast<uint32_t>(cur / 10);
+                rest = cur % 10;
+            }
+            digits += static_cast<char>('0' + rest);
+        } while (limbs[0] || limbs[1] || limbs[2] || limbs[3]);
+        return std::string(digits.rbegin(), digits.rend());
+    }
+};
+
+class MappedTextException : public std::exception {
+public:
+    explicit MappedTextException(const std::string& _path, const std::string& _msg) noexcept : std::exception() {
+        std::stringstream ss;
+        ss << _msg << "\nFile: " << _path;
+        msg = ss.str();
+    }
+    const char* what() const noexcept override {
+        return msg.c_str();
+    }
+private:
+    std::string msg;
+};
+
+/*
+  Read-only mapping of a text file, pages are loaded by OS on demand and may be evicted,
+  so the text does not have to fit into memory
+*/
+class MappedText {
+public:
+    explicit MappedText(const std::string& path) {
+#ifndef _WIN32
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw MappedTextException(path, "Cannot open text");
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            throw MappedTextException(path, "Cannot stat text or text is empty");
+        }
+        void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) {
+            throw MappedTextException(path, "Cannot map text");
+        }
+        data = static_cast<const char*>(mapped);
+        data_size = st.st_size;
+#else
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw MappedTextException(path, "Cannot open text");
+        }
+        buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        data = buffer.data();
+        data_size = buffer.size();
+#endif // !_WIN32
+    }
+    MappedText(const MappedText&) = delete;
+    MappedText& operator = (const MappedText&) = delete;
+    ~MappedText() {
+#ifndef _WIN32
+        munmap(const_cast<char*>(data), data_size);
+#endif // !_WIN32
+    }
+
+    std::string_view view() const { return { data, data_size }; }
+
+private:
+    const char* data = nullptr;
+    size_t data_size = 0;
+#ifdef _WIN32
+    std::string buffer;
+#endif // _WIN32
+};
+
+/*
+  Semi-external counter of distinct substrings.
+  Suffixes are split into buckets by their prefixes. A bucket holding more positions than the memory budget
+  is split by the next symbol, so buckets form a prefix trie, which grows by one level per scan of the text.
+  Buckets (trie leaves) are taken in lexicographic order and grouped into passes holding at most
+  memory_budget bytes of suffix entries; every pass scans the text, sorts entries of its buckets and
+  streams through them, adding suffix length minus lcp with the previous suffix to the answer.
+  Suffixes of one bucket share its prefix, so they are compared past it, and suffixes of different buckets
+  differ within the prefix of their common trie node.
+  Only entries of one pass are resident. The scans read the text sequentially, and an entry keeps
+  KEY_CHARS chars following its bucket prefix, read by the scan as well, so sorting and lcp of neighbours
+  are done in memory while these chars tell suffixes apart.
+
+  Suffixes equal in their keys are compared in the mapped text directly, which is random access
+  all over the file. On natural text such ties are rare, on repetitive text they are the common case:
+  a region repeated more than MAX_BUCKET_DEPTH + KEY_CHARS chars can't be told apart by buckets and keys,
+  so sorting a pass costs O(m log m) comparisons of up to the repeat length at random offsets, m = pass size.
+*/
+class ExternalSubstringCounter {
+public:
+    static const size_t MAX_BUCKET_DEPTH = 64;
+    static const size_t KEY_CHARS = sizeof(uint64_t);
+
+    ExternalSubstringCounter(std::string_view _text, char _first_letter, size_t _voc_size, size_t memory_budget)
+        : text(_text), first_letter(_first_letter), voc_size(_voc_size),
+          max_pass_size(std::max<size_t>(1, memory_budget / sizeof(Entry))) {
+        // text ends at the first char outside of alphabet, e.g. a line break
+        n = 0;
+        for (; n < text.size() && letter(n) != 0; ++n);
+    }
+
+    UInt128 count() {
+        split_buckets();
+        UInt128 result;
+        size_t prev = n; // previous suffix in sorted order, n - none yet
+        for (size_t first = 0; first < leaves.size();) {
+            size_t last = first;
+            uint64_t pass_size = buckets[leaves[first]].size;
+            for (; last + 1 < leaves.size() && pass_size + buckets[leaves[last + 1]].size <= max_pass_size; ++last) {
+                pass_size += buckets[leaves[last + 1]].size;
+            }
+            process_pass(first, last, pass_size, prev, result);
+            first = last + 1;
+        }
+        return result;
+    }
+
+    size_t passes_count() const { return passes; }
+    size_t scans_count() const { return scans; }
+    size_t length() const { return n; }
+
+private:
+    static const size_t NONE = std::numeric_limits<size_t>::max();
+
+    struct Bucket {
+        size_t first_child; // children for every symbol are consecutive, NONE for a leaf
+        size_t depth; // length of the prefix
+        uint64_t size; // number of suffixes, counted for leaves only
+        size_t rank; // index in leaves
+        size_t first_key; // range of first two symbols of suffixes in the bucket, see key
+        size_t last_key;
+    };
+
+    struct Entry {
+        uint64_t chars; // KEY_CHARS chars after the bucket prefix, big-endian, so they compare as integers, 0 past the end
+        uint64_t pos;
+    };
+
+    // letters are numbered from 1, anything else is 0
+    size_t letter(size_t i) const {
+        const auto ch = static_cast<size_t>(text[i] - first_letter) + 1;
+        return ch < voc_size ? ch : 0;
+    }
+
+    // end of text is 0, the smallest symbol
+    size_t symbol(size_t i) const {
+        return i < n ? letter(i) : 0;
+    }
+
+    size_t key(size_t i) const {
+        return symbol(i) * voc_size + symbol(i + 1);
+    }
+
+    size_t find_bucket(size_t i) const {
+        size_t b = 0;
+        for (; buckets[b].first_child != NONE; b = buckets[b].first_child + symbol(i + buckets[b].depth));
+        return b;
+    }
+
+    // a bucket over the budget is split by the symbol after its prefix, symbol 0 child gets the only suffix ending there
+    void split_buckets() {
+        buckets.assign(1, Bucket{ NONE, 0, 0, NONE, 0, voc_size * voc_size - 1 });
+        for (bool split = true; split;) {
+            for (auto& bucket : buckets) {
+                bucket.size = 0;
+            }
+            ++scans;
+            for (size_t i = 0; i < n; ++i) {
+                ++buckets[find_bucket(i)].size;
+            }
+            split = false;
+            for (size_t b = 0, buckets_num = buckets.size(); b < buckets_num; ++b) {
+                if (buckets[b].first_child == NONE && buckets[b].size > max_pass_size && buckets[b].depth < MAX_BUCKET_DEPTH) {
+                    const auto parent = buckets[b];
+                    buckets[b].first_child = buckets.size();
+                    for (size_t c = 0; c < voc_size; ++c) {
+                        const auto step = (parent.depth == 0) ? voc_size : 1;
+                        const auto first_key = (parent.depth < 2) ? parent.first_key + c * step : parent.first_key;
+                        const auto last_key = (parent.depth < 2) ? first_key + step - 1 : parent.last_key;
+                        buckets.push_back(Bucket{ NONE, parent.depth + 1, 0, NONE, first_key, last_key });
+                    }
+                    split = true;
+                }
+            }
+        }
+        // non-empty leaves in lexicographic order
+        leaves.clear();
+        std::vector<size_t> stack = { 0 };
+        while (!stack.empty()) {
+            const auto b = stack.back();
+            stack.pop_back();
+            if (buckets[b].first_child == NONE) {
+                if (buckets[b].size) {
+                    buckets[b].rank = leaves.size();
+                    leaves.push_back(b);
+                }
+                continue;
+            }
+            for (size_t c = voc_size; c-- > 0;) {
+                stack.push_back(buckets[b].first_child + c);
+            }
+        }
+    }
+
+    uint64_t key_chars(size_t i) const {
+        uint64_t chars = 0;
+        for (size_t j = 0; j < KEY_CHARS; ++j) {
+            chars = (chars << 8) | ((i + j < n) ? static_cast<unsigned char>(text[i + j]) : 0);
+        }
+        return chars;
+    }
+
+    size_t common_prefix(size_t a, size_t b, size_t from) const {
+        const auto len = n - std::max(a, b);
+        return std::mismatch(text.data() + a + from, text.data() + a + len, text.data() + b + from).first - (text.data() + a);
+    }
+
+    void process_pass(size_t first, size_t last, uint64_t pass_size, size_t& prev, UInt128& result) {
+        ++passes;
+        // positions are put into place of their bucket right away, buckets of the pass are contiguous in leaves order
+        std::vector<uint64_t> offsets(last - first + 2);
+        for (size_t r = first; r <= last; ++r) {
+            offsets[r - first + 1] = offsets[r - first] + buckets[leaves[r]].size;
+        }
+        std::vector<Entry> entries(pass_size);
+        auto next = offsets;
+        // most positions of a scan belong to other passes, they are dropped by their first two symbols
+        const auto first_key = buckets[leaves[first]].first_key;
+        const auto last_key = buckets[leaves[last]].last_key;
+        for (size_t i = 0; i < n; ++i) {
+            const auto k = key(i);
+            if (k < first_key || last_key < k) {
+                continue;
+            }
+            const auto& bucket = buckets[find_bucket(i)];
+            if (bucket.rank != NONE && first <= bucket.rank && bucket.rank <= last) {
+                entries[next[bucket.rank - first]++] = { key_chars(i + bucket.depth), i };
+            }
+        }
+        for (size_t r = first; r <= last; ++r) {
+            const auto depth = buckets[leaves[r]].depth;
+            const auto begin = entries.begin() + offsets[r - first];
+            const auto end = entries.begin() + offsets[r - first + 1];
+            // a suffix ends with a 0 char of its key, so differing keys order suffixes like the text does
+            std::sort(begin, end, [&](const Entry& a, const Entry& b) {
+                if (a.chars != b.chars) {
+                    return a.chars < b.chars;
+                }
+                const auto len = n - std::max(a.pos, b.pos);
+                const auto from = std::min<size_t>(depth + KEY_CHARS, len);
+                const auto cmp = std::memcmp(text.data() + a.pos + from, text.data() + b.pos + from, len - from);
+                return cmp ? cmp < 0 : a.pos > b.pos; // on equal prefix the shorter suffix goes first
+            });
+            for (auto it = begin; it != end; ++it) {
+                const auto pos = it->pos;
+                size_t lcp = 0;
+                if (it != begin && it->chars != std::prev(it)->chars) {
+                    // the previous suffix of the same bucket shares its prefix and parts with this one within the keys
+                    lcp = depth + leading_equal_chars(it->chars ^ std::prev(it)->chars);
+                } else if (it != begin) {
+                    lcp = common_prefix(prev, pos, std::min<size_t>(depth + KEY_CHARS, n - std::max<size_t>(prev, pos)));
+                } else if (prev < n) {
+                    lcp = common_prefix(prev, pos, 0); // suffixes of different buckets part within the prefix
+                }
+                result += (n - pos) - lcp;
+                prev = pos;
+            }
+        }
+    }
+
+    // number of equal leading chars of two different keys, diff is their xor
+    static size_t leading_equal_chars(uint64_t diff) {
+        size_t equal = 0;
+        for (; !(diff >> (8 * (KEY_CHARS - 1))); diff <<= 8, ++equal);
+        return equal;
+    }
+
+    std::string_view text;
+    char first_letter;
+    size_t voc_size;
+    size_t max_pass_size;
+    size_t n;
+    std::vector<Bucket> buckets; // prefix trie, 0 is the root
+    std::vector<size_t> leaves; // non-empty leaf buckets in lexicographic order
+    size_t passes = 0;
+    size_t scans = 0;
+};
+
+#endif // !EXTERNAL_COUNT_HPP
@@ -22,11 +22,17 @@ aba
 */
 
 #include <iostream>
+#include <cstdint>
 #include <fstream>
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <deque>
 #include <cassert>
+#include <limits>
+
+#include "../../common/fast_io.hpp"
+#include "../../common/compressed_lcp.hpp"
 
 static const char FIRST_LETTER = 'a';
 static const char DELIMITER = FIRST_LETTER - 1;
@@ -53,33 +59,46 @@ std::vector<size_t> get_suffix_array(const std::string& str) {
     size_t classes_count = 1;
     std::vector<size_t> classes(n);
     classes[paddr[0]] = 0;
-    for (int i = 1; i < n; ++i) {
+    for (size_t i = 1; i < n; ++i) {
         classes_count += (str[paddr[i]] != str[paddr[i - 1]]) ? 1 : 0;
         classes[paddr[i]] = classes_count - 1;
     }
 
-    // Sort pairs
+    // Sort pairs. Pass stops as soon as all classes are distinct.
+    // Class pairs are packed into a single word, so renumbering is a linear scan over keys,
+    // and modular indexing is done with conditional adds instead of branches and divisions.
+    // Classes of a text longer than 2^32 don't fit the halves of a key, then the first classes
+    // are compared separately from pn, which is free after the sort.
+    const bool wide = static_cast<uint64_t>(n) > UINT32_MAX;
     std::vector<size_t> pn(n);
-    std::vector<size_t> cn(n);
-    for (size_t k = 0, sub_len = 1ull << k; sub_len < n; ++k, sub_len = 1ull << k) {
-        std::vector<size_t> cnt(classes_count);
-        for (size_t i = 0; i < n; ++i) 
-            pn[i] = ((paddr[i] < sub_len) ? n : 0) + paddr[i] - sub_len;
+    std::vector<uint64_t> keys(n);
+    std::vector<size_t> cnt;
+    for (size_t sub_len = 1; sub_len < n && classes_count < n; sub_len <<= 1) {
+        cnt.assign(classes_count, 0);
         for (size_t i = 0; i < n; ++i)
-            ++cnt[classes[pn[i]]];
+            ++cnt[classes[i]]; // pn is a permutation, so its histogram equals one of all positions
         for (size_t i = 1; i < classes_count; ++i)
             cnt[i] += cnt[i - 1];
+        for (size_t i = 0; i < n; ++i)
+            pn[i] = paddr[i] - sub_len + ((paddr[i] < sub_len) ? n : 0);
         for (size_t i = n - 1; i < n; --i)
             paddr[--cnt[classes[pn[i]]]] = pn[i];
-        cn[paddr[0]] = 0;
+        for (size_t i = 0; i < n; ++i) {
+            size_t mid = paddr[i] + sub_len;
+            mid -= (mid >= n) ? n : 0;
+            if (wide) {
+                pn[i] = classes[paddr[i]];
+                keys[i] = classes[mid];
+            } else {
+                keys[i] = (static_cast<uint64_t>(classes[paddr[i]]) << 32) | classes[mid];
+            }
+        }
         classes_count = 1;
+        classes[paddr[0]] = 0;
         for (size_t i = 1; i < n; ++i) {
-            size_t mid1 = (paddr[i] + sub_len) % n;
-            size_t mid2 = (paddr[i - 1] + sub_len) % n;
-            classes_count += (classes[paddr[i]] != classes[paddr[i - 1]] || classes[mid1] != classes[mid2]) ? 1 : 0;
-            cn[paddr[i]] = classes_count - 1;
+            classes_count += (keys[i] != keys[i - 1] || (wide && pn[i] != pn[i - 1])) ? 1 : 0;
+            classes[paddr[i]] = classes_count - 1;
         }
-        std::copy(cn.begin(), cn.end(), classes.begin());
     }
 
     return paddr;
@@ -93,55 +112,141 @@ std::vector <size_t> get_suffix_pos(const std::vector<size_t>& suffix_array) {
     return suffix_positions;
 }
 
-std::vector<size_t> get_lcp(const std::string& str, const std::vector<size_t>& suffix_array) {
+/*
+  Common prefixes are cut at DELIMITER, so a common prefix never spans two documents
+*/
+CompressedLcp get_lcp(const std::string& str, const std::vector<size_t>& suffix_array) {
     const auto n = str.size();
-    std::vector<size_t> result(n);
+    CompressedLcp result(n);
     size_t cur = 0;
     const auto pos = get_suffix_pos(suffix_array);
     for (size_t i = 0; i < n - 1; ++i) {
         const auto& posi = pos[i];
         cur -= (cur > 0) ? 1 : 0;
         if (posi == n - 1) {
-            result[n - 1] = 0;
+            result.set(n - 1, 0);
             cur = 0;
         } else {
-            for (auto j = suffix_array[posi + 1]; std::max(i + cur, j + cur) < n && str[i + cur] == str[j + cur]; ++cur);
+            for (auto j = suffix_array[posi + 1]; std::max(i + cur, j + cur) < n && str[i + cur] == str[j + cur] && str[i + cur] != DELIMITER; ++cur);
         }
-        result[pos[i]] = cur;
+        result.set(pos[i], cur);
     }
+    result.finish();
     return result;
 }
 
-auto get_sub_str(const std::string& str, const std::string& str2, const std::vector<size_t>& suffix_arr) {
+/*
+  Concatenate documents into a single text: doc_1 DELIMITER doc_2 DELIMITER ... doc_N PLACEHOLDER
+  and mark every position with an id of its document (NO_DOC for separators)
+*/
+static const size_t NO_DOC = std::numeric_limits<size_t>::max();
+
+auto concat_docs(const std::vector<std::string>& docs) {
+    std::string str;
+    std::vector<size_t> doc_ids;
+    for (size_t d = 0; d < docs.size(); ++d) {
+        str += docs[d];
+        str += (d + 1 < docs.size()) ? DELIMITER : PLACEHOLDER;
+        doc_ids.resize(str.size(), d);
+        doc_ids.back() = NO_DOC;
+    }
+    return std::make_pair(str, doc_ids);
+}
+
+/*
+  Every document contains itself, so with k <= 1 the answer is the longest document,
+  the lexicographically smallest one among equally long. Returns text position and length.
+*/
+std::pair<size_t, size_t> get_longest_doc(const std::string& str, const std::vector<size_t>& doc_ids) {
+    size_t best_begin = 0;
+    size_t best_size = 0;
+    for (size_t begin = 0; begin < str.size();) {
+        size_t end = begin;
+        for (; doc_ids[end] != NO_DOC; ++end);
+        const auto size = end - begin;
+        if (size > best_size || (size == best_size && str.compare(begin, size, str, best_begin, best_size) < 0)) {
+            best_begin = begin;
+            best_size = size;
+        }
+        begin = end + 1;
+    }
+    return { best_begin, best_size };
+}
+
+/*
+  Longest substring common to at least k > 1 documents. Returns text position and length.
+  Sliding window over the generalized suffix array keeps the shortest window with k distinct documents
+  for every right end, its minimal lcp is kept by a monotonic deque, so the scan is O(n).
+*/
+auto get_sub_str(const std::string& str, const std::vector<size_t>& doc_ids, const std::vector<size_t>& suffix_arr, size_t docs_num, size_t k) {
     const auto lcp = get_lcp(str, suffix_arr);
+    const auto str_size = str.size();
     size_t common_substr_index = 0;
     size_t common_substr_size = 0;
-    const auto str_size = str.size();
-    const auto str2_pos = str_size - str2.size() - 1;
-    const auto is_suf_in_str2 = [&](size_t i) { return str2_pos <= suffix_arr[i]; };
-    for (size_t i = 1; i < str_size; ++i) {
-        if (is_suf_in_str2(i - 1) != is_suf_in_str2(i)) {
-            const size_t cur_size = lcp[i - 1];
+    // suffixes starting with separators are the smallest ones
+    const auto first = docs_num;
+    std::vector<size_t> doc_count(docs_num);
+    size_t distinct_docs = 0;
+    std::deque<std::pair<size_t, size_t>> window_min; // (index, value) of lcp in window with increasing values
+    CompressedLcp::Scanner lcp_scan(lcp);
+    const auto doc_at = [&](size_t i) { return doc_ids[suffix_arr[i]]; };
+    for (size_t l = first, r = first; r < str_size; ++r) {
+        distinct_docs += (doc_count[doc_at(r)]++ == 0) ? 1 : 0;
+        if (r > l) {
+            const auto cur_lcp = lcp_scan[r - 1];
+            while (!window_min.empty() && window_min.back().second >= cur_lcp) {
+                window_min.pop_back();
+            }
+            window_min.emplace_back(r - 1, cur_lcp);
+        }
+        while (l < r && (doc_count[doc_at(l)] > 1 || distinct_docs > k)) {
+            distinct_docs -= (--doc_count[doc_at(l)] == 0) ? 1 : 0;
+            ++l;
+        }
+        while (!window_min.empty() && window_min.front().first < l) {
+            window_min.pop_front();
+        }
+        if (distinct_docs >= k && !window_min.empty()) {
+            const size_t cur_size = window_min.front().second;
             if (cur_size > common_substr_size) {
                 common_substr_size = cur_size;
-                common_substr_index = i;
+                common_substr_index = l;
             }
         }
     }
-    return std::make_pair(common_substr_index, common_substr_size);
+    return std::make_pair(suffix_arr[common_substr_index], common_substr_size);
 }
 
-int main() {
+/*
+  Usage:
+    app            two strings from stdin, their longest common substring is printed
+    app --multi    "N k" and N documents from stdin, longest substring common to at least k of them is printed
+*/
+int main(int argc, char* argv[]) {
 #ifdef _DEBUG
     std::ifstream input_stream("input.txt");
     std::cin.rdbuf(input_stream.rdbuf());
 #endif
     std::ios::sync_with_stdio(false), std::cin.tie(0), std::cout.tie(0);
-    std::string str1, str2;
-    std::cin >> str1 >> str2;
-    const auto str = str1 + DELIMITER + str2 + PLACEHOLDER;
-    const auto suffix_arr = get_suffix_array(str);
-    const auto [common_substr_index, common_substr_size] = get_sub_str(str, str2, suffix_arr);
-    std::cout << str.substr(suffix_arr[common_substr_index], common_substr_size);
+    FastReader in(std::cin);
+    std::vector<std::string> docs(2);
+    size_t k = 2;
+    if (argc > 1 && std::string(argv[1]) == "--multi") {
+        size_t docs_num = 0;
+        in.read(docs_num);
+        in.read(k);
+        docs.resize(docs_num);
+    }
+    for (auto& doc : docs) {
+        in.read(doc);
+    }
+    if (docs.empty()) {
+        return EXIT_SUCCESS; // N = 0, the answer is empty and there is no text to build a suffix array of
+    }
+    const auto [str, doc_ids] = concat_docs(docs);
+    const auto [common_substr_pos, common_substr_size] = (k <= 1)
+        ? get_longest_doc(str, doc_ids)
+        : get_sub_str(str, doc_ids, get_suffix_array(str), docs.size(), k);
+    std::cout << str.substr(common_substr_pos, common_substr_size);
     return EXIT_SUCCESS;
 }
\ No newline at end of file
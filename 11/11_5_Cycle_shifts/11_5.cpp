@@ -32,11 +32,14 @@ IMPOSSIBLE
 */
 
 #include <iostream>
+#include <cstdint>
 #include <fstream>
 #include <vector>
 #include <string>
 #include <algorithm>
 
+#include "../../common/fast_io.hpp"
+
 static const char FIRST_LETTER = static_cast<char>(32);
 static const char PLACEHOLDER = FIRST_LETTER - 1;
 static const size_t VOC_SIZE = static_cast<char>(126) - PLACEHOLDER + 1;
@@ -45,7 +48,11 @@ size_t inline char_addr(char ch) {
     return ch - PLACEHOLDER;
 }
 
-std::vector<size_t> get_suffix_array(const std::string& str) {
+/*
+  Prefix doubling works modulo n, so without a placeholder it sorts cyclic shifts of str.
+  Returns shifts order and equivalence classes: equal shifts share a class, classes follow sorted order.
+*/
+std::pair<std::vector<size_t>, std::vector<size_t>> sort_cyclic_shifts(const std::string& str) {
     const auto n = str.length ();
     size_t count[VOC_SIZE] = { 0 };
     std::vector<size_t> paddr(n);
@@ -61,64 +68,102 @@ std::vector<size_t> get_suffix_array(const std::string& str) {
     size_t classes_count = 1;
     std::vector<size_t> classes(n);
     classes[paddr[0]] = 0;
-    for (int i = 1; i < n; ++i) {
+    for (size_t i = 1; i < n; ++i) {
         classes_count += (str[paddr[i]] != str[paddr[i - 1]]) ? 1 : 0;
         classes[paddr[i]] = classes_count - 1;
     }
 
-    // Sort pairs
+    // Sort pairs. Pass stops as soon as all classes are distinct.
+    // Class pairs are packed into a single word, so renumbering is a linear scan over keys,
+    // and modular indexing is done with conditional adds instead of branches and divisions.
+    // Classes of a text longer than 2^32 don't fit the halves of a key, then the first classes
+    // are compared separately from pn, which is free after the sort.
+    const bool wide = static_cast<uint64_t>(n) > UINT32_MAX;
     std::vector<size_t> pn(n);
-    std::vector<size_t> cn(n);
-    for (size_t k = 0, sub_len = 1ull << k; sub_len < n; ++k, sub_len = 1ull << k) {
-        std::vector<size_t> cnt(classes_count);
-        for (size_t i = 0; i < n; ++i) 
-            pn[i] = ((paddr[i] < sub_len) ? n : 0) + paddr[i] - sub_len;
+    std::vector<uint64_t> keys(n);
+    std::vector<size_t> cnt;
+    for (size_t sub_len = 1; sub_len < n && classes_count < n; sub_len <<= 1) {
+        cnt.assign(classes_count, 0);
         for (size_t i = 0; i < n; ++i)
-            ++cnt[classes[pn[i]]];
+            ++cnt[classes[i]]; // pn is a permutation, so its histogram equals one of all positions
         for (size_t i = 1; i < classes_count; ++i)
             cnt[i] += cnt[i - 1];
+        for (size_t i = 0; i < n; ++i)
+            pn[i] = paddr[i] - sub_len + ((paddr[i] < sub_len) ? n : 0);
         for (size_t i = n - 1; i < n; --i)
             paddr[--cnt[classes[pn[i]]]] = pn[i];
-        cn[paddr[0]] = 0;
+        for (size_t i = 0; i < n; ++i) {
+            size_t mid = paddr[i] + sub_len;
+            mid -= (mid >= n) ? n : 0;
+            if (wide) {
+                pn[i] = classes[paddr[i]];
+                keys[i] = classes[mid];
+            } else {
+                keys[i] = (static_cast<uint64_t>(classes[paddr[i]]) << 32) | classes[mid];
+            }
+        }
         classes_count = 1;
+        classes[paddr[0]] = 0;
         for (size_t i = 1; i < n; ++i) {
-            size_t mid1 = (paddr[i] + sub_len) % n;
-            size_t mid2 = (paddr[i - 1] + sub_len) % n;
-            classes_count += (classes[paddr[i]] != classes[paddr[i - 1]] || classes[mid1] != classes[mid2]) ? 1 : 0;
-            cn[paddr[i]] = classes_count - 1;
+            classes_count += (keys[i] != keys[i - 1] || (wide && pn[i] != pn[i - 1])) ? 1 : 0;
+            classes[paddr[i]] = classes_count - 1;
         }
-        std::copy(cn.begin(), cn.end(), classes.begin());
     }
 
-    return paddr;
+    return { paddr, classes };
 }
 
-std::vector <size_t> get_suffix_pos(const std::vector<size_t>& suffix_array) {
-    std::vector<size_t> suffix_positions(suffix_array.size());
-    for (size_t i = 0; i < suffix_array.size(); ++i) {
-        suffix_positions[suffix_array[i]] = i;
+/*
+  Start of the lexicographically minimal cyclic shift in O(n) time and O(1) memory.
+  Candidates i and j are compared char by char modulo n, on mismatch the greater one
+  with all shifts inside the matched part is skipped.
+*/
+size_t get_min_shift(const std::string& str) {
+    const auto n = str.size();
+    size_t i = 0, j = 1, k = 0;
+    while (i < n && j < n && k < n) {
+        const auto a = str[(i + k) % n];
+        const auto b = str[(j + k) % n];
+        if (a == b) {
+            ++k;
+            continue;
+        }
+        (a > b ? i : j) += k + 1;
+        j += (i == j) ? 1 : 0;
+        k = 0;
     }
-    return suffix_positions;
+    return std::min(i, j);
 }
 
-std::vector<size_t> get_lcp(const std::string& str, const std::vector<size_t>& suffix_array) {
-    const auto n = str.size();
-    std::vector<size_t> result(n);
-    size_t cur = 0;
-    const auto pos = get_suffix_pos(suffix_array);
-    for (size_t i = 0; i < n - 1; ++i) {
-        const auto& posi = pos[i];
-        cur -= (cur > 0) ? 1 : 0;
-        if (posi == n - 1) {
-            result[n - 1] = 0;
-            cur = 0;
-        } else {
-            for (auto j = suffix_array[posi + 1]; std::max(i + cur, j + cur) < n && str[i + cur] == str[j + cur]; ++cur);
+std::string get_shift(const std::string& str, size_t start) {
+    return str.substr(start) + str.substr(0, start);
+}
+
+/*
+  Sorted distinct cyclic shifts built once, answers any number of k-th shift queries
+*/
+class CyclicShifts {
+public:
+    explicit CyclicShifts(const std::string& _str) : str(_str) {
+        const auto [order, classes] = sort_cyclic_shifts(str);
+        for (const auto shift : order) {
+            if (first_shifts.size() == classes[shift]) {
+                first_shifts.push_back(shift);
+            }
         }
-        result[pos[i]] = cur;
     }
-    return result;
-}
+
+    size_t distinct_count() const { return first_shifts.size(); }
+
+    // k-th distinct shift in sorted order, 1-based
+    std::string get(size_t k) const {
+        return get_shift(str, first_shifts[k - 1]);
+    }
+
+private:
+    const std::string& str;
+    std::vector<size_t> first_shifts; // first shift of every class
+};
 
 int main() {
 #ifdef _DEBUG
@@ -126,25 +171,25 @@ int main() {
     std::cin.rdbuf(input_stream.rdbuf());
 #endif
     std::ios::sync_with_stdio(false), std::cin.tie(0), std::cout.tie(0);
+    FastReader in(std::cin);
     std::string str;
-    int expected_cycles;
-    std::cin >> str >> expected_cycles;
-    str += str + PLACEHOLDER;
-    const auto suffix_arr = get_suffix_array(str);
-    const auto lcp = get_lcp(str, suffix_arr);
-
-    const auto str_size = str.size();
-    int cycle_count = 0;
-    for (size_t i = 1; i < str_size; ++i) {
-        const auto lcp_val = lcp[i];
-        const auto suffix_size = str_size - suffix_arr[i] - 1;
-        cycle_count += ((lcp_val < suffix_size) ? 1 : 0);
-        if (cycle_count == expected_cycles) {
-            std::cout << str.substr(suffix_arr[i], str_size / 2);
-            return EXIT_SUCCESS;
-        }
+    in.read(str);
+    std::vector<size_t> queries;
+    for (size_t k; in.read(k);) {
+        queries.push_back(k);
+    }
+
+    FastWriter out(std::cout);
+    // the minimal shift does not need sorting at all
+    if (queries.size() == 1 && queries[0] == 1) {
+        out << get_shift(str, get_min_shift(str));
+        return EXIT_SUCCESS;
     }
-    std::cout << "IMPOSSIBLE";
-    return EXIT_SUCCESS;
-}
 
+    const CyclicShifts shifts(str);
+    for (size_t q = 0; q < queries.size(); ++q) {
+        const auto k = queries[q];
+        out << ((k >= 1 && k <= shifts.distinct_count()) ? shifts.get(k) : "IMPOSSIBLE") << (q + 1 < queries.size() ? "\n" : "");
+    }
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
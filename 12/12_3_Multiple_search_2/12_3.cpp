@@ -1,189 +1,49 @@
-﻿/*
-Theory
-Probably, the best explanation of Ukkonen's algorithm:
-https://stackoverflow.com/questions/9452701/ukkonens-suffix-tree-algorithm-in-plain-english/9513423#9513423
-
-Though, it doesn't cover all details, which are described further:
-https://stackoverflow.com/questions/9452701/ukkonens-suffix-tree-algorithm-in-plain-english/14580102#14580102
-
-For easier understanding of building tree process there is also an
-awesome visualizer of Ukkonen's tree step-by-step: https://brenden.github.io/ukkonen-animation/
-*/
-#include <iostream>
+﻿#include <iostream>
 #include <fstream>
 #include <string>
 #include <vector>
-#include <unordered_map>
 #include <algorithm>
 #include <cassert>
+#include <thread>
 
-#ifdef _DEBUG
-#include "memcheck_crt.h"
-#endif // _DEBUG
-
-class Tree {
-public:
-    static const size_t INF = std::numeric_limits<size_t>::max();
-
-protected:
-    struct Node {
-        explicit Node(size_t _l) : l(_l) {}
-        explicit Node(size_t _l, size_t _r) : l(_l), r(_r) {}
-        size_t l = 0;
-        size_t r = INF;
-        size_t suff_link = 0;
-        std::unordered_map<char, size_t> edges;
-    };
-public:
-    Tree(std::string& _text) : text(_text) {}
+#include "../../common/fast_io.hpp"
+#include "../../common/suffix_tree.hpp"
+#include "generalized_suffix_tree.hpp"
+#include "tree_snapshot.hpp"
+#include "../../common/cli_args.hpp"
 
-    /*
-      Build a tree. Function is online, so whenever you extend text, you can continue building a tree calling this function
-      except for case when string is terminated.
-    */
-    void build() {
-        assert(!terminated);
-        nodes.reserve(text.size() * 2);
-        for (; text_length < text.size(); ++text_length) {
-            extend();
 #ifdef _DEBUG
-            //pretty_print();
+#include "memcheck_crt.h"
 #endif // _DEBUG
-        }
-    }
-
-protected:
-    size_t get_node_length(const Node& node) {
-        return std::min(node.r, text_length + 1) - node.l;
-    }
 
-private:
-    char active_edge_char() const {
-        return text[active_edge_index];
-    }
-
-    void add_suffix_link(size_t node_index) {
-        if (need_sl_index > 0) {
-            nodes[need_sl_index].suff_link = node_index;
-        }
-        need_sl_index = node_index;
-    }
-
-    bool walk_down(size_t node_index) {
-        auto edge_length = get_node_length(nodes[node_index]);
-        if (active_node_length < edge_length) {
-            return false;
-        }
-        active_edge_index += edge_length;
-        active_node_length -= edge_length;
-        active_node_index = node_index;
-        return true;
-    }
-
-    void extend() {
-        need_sl_index = 0;
-        ++remainder;
-        while (remainder) {
-            if (active_node_length == 0) {
-                active_edge_index = text_length;
-            }
-            auto& edges = nodes[active_node_index].edges;
-            const auto edge_char = active_edge_char();
-            const auto& search_iter_ch = edges.find(edge_char);
-            if (search_iter_ch == edges.end()) {
-                nodes.emplace_back(text_length);
-                edges[edge_char] = nodes.size() - 1;
-                add_suffix_link(active_node_index);
-            } else {
-                const auto edge_index = (*search_iter_ch).second;
-                // Observation 1:
-                // When the final suffix we need to insert is found to exist in the tree already, 
-                // the tree itself is not changed at all(we only update the active point and remainder)
-                if (walk_down(edge_index)) {
-                    continue;
-                }
+static const size_t MIN_WORDS_PER_THREAD = 1 << 12;
 
-                auto& edge_left_pos = nodes[edge_index].l;
-                const auto edge_right_pos = edge_left_pos + active_node_length;
-                // Observation 2
-                // If at some point active_length is greater or equal to the length of current edge (edge_length), 
-                // we move our active point down until edge_length is strictly greater than active_length.
-                const auto cur_char = text[text_length];
-                if (text[edge_right_pos] == cur_char) {
-                    ++active_node_length;
-                    // Observation 3
-                    // When the symbol we want to add to the tree is already on the edge, we, according to Observation 1,
-                    // update only active point and remainder, leaving the tree unchanged.
-                    // BUT if there is an internal node marked as needing suffix link,
-                    // we must connect that node with our current active node through a suffix link.
-                    add_suffix_link(active_node_index);
-                    break;
-                }
-                auto& mid_node = nodes.emplace_back(edge_left_pos, edge_right_pos); // Add a new middle node
-                const auto mid_index = nodes.size() - 1;
-                nodes[active_node_index].edges[active_edge_char()] = mid_index; // Relink active node edge to middle node
-                nodes.emplace_back(text_length); // Add a new leaf node
-                auto& mid_node_edges = mid_node.edges;
-                mid_node_edges[cur_char] = nodes.size() - 1; // Add mid_node-new_leaf link
-                edge_left_pos += active_node_length;
-                mid_node_edges[text[edge_left_pos]] = edge_index; // Add mid_node-old_leaf link
-                // Rule 2
-                // If we create a new internal node OR make an inserter from an internal node, 
-                // and this is not the first SUCH internal node at current step, 
-                // then we link the previous SUCH node with THIS one through a suffix link.
-                add_suffix_link(mid_index);
-            }
-            --remainder;
-            if (active_node_index == 0 && active_node_length > 0) {
-                // Rule 1
-                // If after an insertion from the active node = root, the active length is greater than 0, then:
-                // 1. active node is not changed
-                // 2. active length is decremented
-                // 3. active edge is shifted right(to the first character of the next suffix we must insert)
-                --active_node_length;
-                active_edge_index = text_length - remainder + 1;
-            } else {
-                // Rule 3
-                // After an insert from the active node which is not the root node,
-                // we must follow the suffix linkand set the active node to the node it points to.
-                // If there is no a suffix link, set the active node to the root node.
-                // Either way, active edge and active length stay unchanged.
-                active_node_index = nodes[active_node_index].suff_link;
-            }
-        }
-    }
-
-    void pretty_print(size_t node_index, std::string pad) {
-        const auto& node = nodes[node_index];
-        const auto node_length = get_node_length(node);
-        const std::string delim = " ";
-        const std::string suff_str = node.suff_link ? "(" + std::to_string(node.suff_link) + ")" : "";
-        std::cout << pad << node_index << suff_str << delim << text.substr(node.l, node_length) << "\n";
-        pad = "  " + pad;
-        for (const auto& [_, val] : node.edges) {
-            pretty_print(val, pad);
+/*
+  Answers for all words in input order. The tree is not changed after it is prepared,
+  so threads walk it without any synchronization; words are split into contiguous chunks
+  and every thread writes only its own part of the result.
+*/
+template <typename Searcher>
+std::vector<size_t> get_all_inclusion_nums(const Searcher& searcher, const std::vector<std::string>& words, size_t threads_num) {
+    std::vector<size_t> result(words.size());
+    const auto answer = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            result[i] = searcher.get_inclusion_nums(words[i]);
         }
+    };
+    threads_num = std::max<size_t>(1, std::min(threads_num, words.size() / MIN_WORDS_PER_THREAD));
+    const size_t chunk = (words.size() + threads_num - 1) / threads_num;
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < threads_num; ++t) {
+        const size_t begin = std::min(words.size(), t * chunk);
+        threads.emplace_back(answer, begin, std::min(words.size(), begin + chunk));
     }
-
-    void pretty_print() {
-        std::cout << text.substr(0, text_length + 1) << "\n";
-        std::cout << "active index=" << active_node_index << " edge=" << active_edge_char() << " length=" << active_node_length << "\n";
-        pretty_print(0, "");
-        std::cout << "\n";
+    answer(0, std::min(words.size(), chunk));
+    for (auto& thread : threads) {
+        thread.join();
     }
-
-protected:
-    bool terminated = false;
-    size_t need_sl_index = 0; // node, that needs a suffix link
-    size_t active_node_index = 0; // index of active node
-    size_t active_edge_index = 0; // index of active edge char in text
-    size_t active_node_length = 0; // distance between current position and beggining of active node position
-    size_t remainder = 0; // how many leafs to add to make tree completed (with active_node_length=0)
-    size_t text_length = 0; // length of processed text
-    std::string& text;
-    std::vector<Node> nodes{ Node(0, 0) };
-};
-
+    return result;
+}
 
 class SolverTree : public Tree {
 private:
@@ -191,31 +51,46 @@ private:
 public:
     SolverTree() : Tree(text) {}
 
-    size_t get_inclusion_nums(const std::string& word) {
+    size_t get_inclusion_nums(const std::string& word) const {
         auto node_index = walk_word(word);
         return node_index < INF ? inclusion_nums[node_index] : 0;
     }
 
+    std::vector<size_t> get_inclusion_nums(const std::vector<std::string>& words, size_t threads_num) const {
+        return get_all_inclusion_nums(*this, words, threads_num);
+    }
+
+    // image of the terminated tree, which can answer the same queries without building
+    void write_snapshot(const std::string& path) const {
+        assert(terminated);
+        TreeSnapshot::write(path, text, nodes, nodes.size(), inclusion_nums);
+    }
+
     void prepare_inclusions_num() {
         terminate();
         inclusion_nums.resize(nodes.size());
-        prepare_inclusions_num(0);
+        // leaves under a node are the ones met between entering and leaving it
+        size_t leaves = 0;
+        traverse([&](size_t node_index, size_t) {
+            inclusion_nums[node_index] = leaves;
+            leaves += is_leaf(node_index) ? 1 : 0;
+        }, [&](size_t node_index, size_t) {
+            inclusion_nums[node_index] = leaves - inclusion_nums[node_index];
+        });
     }
 
-    size_t walk_word(const std::string& word) {
+    size_t walk_word(const std::string& word) const {
         size_t node_index = 0;
         size_t ch_pos = 0;
         size_t depth = 0;
         while (ch_pos < word.size()) {
-            auto& node = nodes[node_index];
+            const auto& node = nodes[node_index];
             auto ch = word[ch_pos];
-            if (get_node_length(node) == depth) {
-                const auto& edges = node.edges;
-                const auto& search_iter_ch = edges.find(ch);
-                if (search_iter_ch == edges.end()) {
+            if (get_node_length(node_index) == depth) {
+                node_index = find_child(node_index, ch);
+                if (!node_index) {
                     return INF;
                 }
-                node_index = (*search_iter_ch).second;
                 depth = 0;
             } else if (text[node.l + depth] != ch) {
                 return INF;
@@ -226,20 +101,6 @@ public:
         return node_index;
     }
 private:
-    size_t prepare_inclusions_num(size_t node_index) {
-        size_t inclusion_num = 0;
-        const auto& node = nodes[node_index];
-        if (node.r != INF) {
-            for (const auto& edge : node.edges) {
-                inclusion_num += prepare_inclusions_num(edge.second);
-            }
-        } else {
-            inclusion_num = 1;
-        }
-        inclusion_nums[node_index] = inclusion_num;
-        return inclusion_num;
-    }
-
     /*
         Force completing tree by adding a unique char to the end
         After this online additive building becomes a nonsence operation
@@ -257,29 +118,107 @@ private:
     std::vector<size_t> inclusion_nums;
 };
 
-void solve_multiple_search() {
-    int n;
-    std::cin >> n;
+std::vector<std::string> read_words(FastReader& in) {
+    size_t n = 0;
+    in.read(n);
     std::vector<std::string> words(n);
     for (auto& word : words) {
-        std::cin >> word;
+        in.read(word);
     }
+    return words;
+}
+
+void solve_multiple_search(size_t threads_num) {
+    FastReader in(std::cin);
+    FastWriter out(std::cout);
+    const auto words = read_words(in);
     SolverTree utree;
-    std::cin >> utree.text;
+    in.read(utree.text);
     utree.build();
     utree.prepare_inclusions_num();
-    for (auto& word : words) {
-        std::cout << utree.get_inclusion_nums(word) << "\n";
+    for (const auto inclusion_num : utree.get_inclusion_nums(words, threads_num)) {
+        out << inclusion_num << '\n';
+    }
+}
+
+void build_snapshot(const std::string& path) {
+    FastReader in(std::cin);
+    SolverTree utree;
+    in.read(utree.text);
+    utree.build();
+    utree.prepare_inclusions_num();
+    utree.write_snapshot(path);
+}
+
+void solve_snapshot_search(const TreeSnapshot& snapshot, size_t threads_num) {
+    FastReader in(std::cin);
+    FastWriter out(std::cout);
+    for (const auto inclusion_num : get_all_inclusion_nums(snapshot, read_words(in), threads_num)) {
+        out << inclusion_num << '\n';
+    }
+}
+
+void solve_documents_search() {
+    FastReader in(std::cin);
+    FastWriter out(std::cout);
+    DocumentTree tree;
+    size_t docs_num = 0;
+    in.read(docs_num);
+    for (size_t i = 0; i < docs_num; ++i) {
+        tree.add_document(in.token());
+    }
+    tree.prepare_documents();
+    size_t n = 0;
+    in.read(n);
+    for (size_t i = 0; i < n; ++i) {
+        const auto word = in.token();
+        out << tree.get_document_frequency(word);
+        for (const auto doc : tree.get_documents(word)) {
+            out << ' ' << doc + 1;
+        }
+        out << '\n';
     }
 }
 
-int main() {
+/*
+  Usage:
+    app [--threads N]                            n, words and text from stdin, words are answered by N threads
+    app --documents                              N, documents, n and words from stdin, for every word the number
+                                                 of documents containing it and their 1-based ids are printed
+    app --build-snapshot FILE                    text from stdin, the prepared tree is saved to FILE
+    app --snapshot FILE [--verify] [--threads N] n and words from stdin, the tree is mapped from FILE
+                                                 nodes are always checked, --verify also checks the checksum of text and counts
+*/
+int main(int argc, char* argv[]) {
 #ifdef _DEBUG
     ENABLE_CRT;
     std::ifstream input_stream("input.txt");
     std::cin.rdbuf(input_stream.rdbuf());
 #endif // _DEBUG
     std::ios::sync_with_stdio(false), std::cin.tie(0), std::cout.tie(0);
-    solve_multiple_search();
+    const std::vector<std::string> args(argv + 1, argv + argc);
+    if (has_flag(args, "--documents")) {
+        solve_documents_search();
+        return EXIT_SUCCESS;
+    }
+    const auto threads_num = get_threads_num(args);
+    if (!threads_num) {
+        std::cerr << THREADS_ERROR << "\n";
+        return EXIT_FAILURE;
+    }
+    if (args.size() >= 2 && args[0] == "--build-snapshot") {
+        build_snapshot(args[1]);
+        return EXIT_SUCCESS;
+    }
+    if (args.size() >= 2 && args[0] == "--snapshot") {
+        try {
+            solve_snapshot_search(TreeSnapshot::load(args[1], has_flag(args, "--verify")), *threads_num);
+        } catch (const TreeSnapshotException& e) {
+            std::cerr << e.what() << "\n";
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+    solve_multiple_search(*threads_num);
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,143 @@
+#pragma once
+#ifndef GENERALIZED_SUFFIX_TREE_HPP
+#define GENERALIZED_SUFFIX_TREE_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#include "../../common/suffix_tree.hpp"
+
+/*
+  One suffix tree over a collection of documents. Documents are concatenated, each one is followed
+  by its own terminator, so no path from root goes through a document end and every suffix of every
+  document gets a leaf. Terminators don't fit into char, hence the char32_t alphabet:
+  chars keep their values and terminator of document i is LAST_TERMINATOR - i.
+  Terminators go down from the top, so in a sorted children list the newest terminator is
+  right after the chars: a node may collect a terminator child from every document,
+  adding one more still scans only the chars.
+  The tree is built online, add_document continues Ukkonen's extend() from where it stopped.
+*/
+class DocumentTree : public BasicTree<uint32_t, char32_t> {
+public:
+    static const char32_t LAST_TERMINATOR = std::numeric_limits<char32_t>::max();
+
+    DocumentTree() : BasicTree(text) {}
+
+    void add_document(std::string_view document) {
+        for (const auto ch : document) {
+            text += static_cast<char32_t>(static_cast<unsigned char>(ch));
+        }
+        text += static_cast<char32_t>(LAST_TERMINATOR - doc_ends.size());
+        doc_ends.push_back(text.size());
+        build();
+        prepared = false;
+    }
+
+    size_t documents_num() const {
+        return doc_ends.size();
+    }
+
+    /*
+      Must be called after the last add_document and before queries.
+      One walk gives every node the range of its leaves in depth-first order, document of every leaf
+      and the number of distinct documents under every node. Leaves of the same document
+      are counted once per node: a node is charged -1 for every pair of consecutive (in depth-first order)
+      leaves of the same document that have it as the lowest common ancestor, charges are summed up the tree.
+    */
+    void prepare_documents() {
+        leaf_begins.assign(nodes.size(), 0);
+        leaf_ends.assign(nodes.size(), 0);
+        doc_counts.assign(nodes.size(), 0); // charges until a node is left
+        leaf_docs.clear();
+        std::vector<size_t> last_leaf(doc_ends.size(), INF);
+        std::vector<size_t> path; // nodes from root to the current one
+        traverse([&](size_t node_index, size_t depth) {
+            const auto rank = leaf_docs.size();
+            leaf_begins[node_index] = static_cast<uint32_t>(rank);
+            if (is_leaf(node_index)) {
+                const auto doc = get_document(nodes[node_index].l - (depth - get_node_length(node_index)));
+                if (last_leaf[doc] != INF) {
+                    // the deepest node on the path which was entered before the previous leaf of the document
+                    const auto lca = std::upper_bound(path.begin(), path.end(), last_leaf[doc], [&](size_t leaf, size_t node) {
+                        return leaf < leaf_begins[node];
+                    }) - 1;
+                    ++doc_counts[*lca];
+                }
+                last_leaf[doc] = rank;
+                leaf_docs.push_back(static_cast<uint32_t>(doc));
+            }
+            path.push_back(node_index);
+        }, [&](size_t node_index, size_t) {
+            path.pop_back();
+            const auto charges = doc_counts[node_index];
+            if (!path.empty()) {
+                doc_counts[path.back()] += charges;
+            }
+            leaf_ends[node_index] = static_cast<uint32_t>(leaf_docs.size());
+            doc_counts[node_index] = static_cast<uint32_t>(leaf_docs.size() - leaf_begins[node_index] - charges);
+        });
+        prepared = true;
+    }
+
+    // number of documents, which contain a word
+    size_t get_document_frequency(std::string_view word) const {
+        assert(prepared);
+        const auto node_index = walk_word(word);
+        return node_index < INF ? doc_counts[node_index] : 0;
+    }
+
+    // sorted ids of documents, which contain a word
+    std::vector<size_t> get_documents(std::string_view word) const {
+        assert(prepared);
+        std::vector<size_t> docs;
+        const auto node_index = walk_word(word);
+        if (node_index == INF) {
+            return docs;
+        }
+        docs.assign(leaf_docs.begin() + leaf_begins[node_index], leaf_docs.begin() + leaf_ends[node_index]);
+        std::sort(docs.begin(), docs.end());
+        docs.erase(std::unique(docs.begin(), docs.end()), docs.end());
+        return docs;
+    }
+
+private:
+    size_t get_document(size_t text_pos) const {
+        return std::upper_bound(doc_ends.begin(), doc_ends.end(), text_pos) - doc_ends.begin();
+    }
+
+    // node, which edge the word ends at, INF if the word is not in text
+    size_t walk_word(std::string_view word) const {
+        size_t node_index = 0;
+        size_t depth = 0;
+        for (const auto ch : word) {
+            const char32_t symbol = static_cast<unsigned char>(ch);
+            if (get_node_length(node_index) == depth) {
+                node_index = find_child(node_index, symbol);
+                if (!node_index) {
+                    return INF;
+                }
+                depth = 0;
+            } else if (text[nodes[node_index].l + depth] != symbol) {
+                return INF;
+            }
+            ++depth;
+        }
+        return node_index;
+    }
+
+public:
+    Text text;
+private:
+    bool prepared = false;
+    std::vector<size_t> doc_ends; // text position after every terminator
+    std::vector<uint32_t> leaf_begins; // leaves under a node are [leaf_begins, leaf_ends) in depth-first order
+    std::vector<uint32_t> leaf_ends;
+    std::vector<uint32_t> leaf_docs; // document of every leaf in depth-first order
+    std::vector<uint32_t> doc_counts;
+};
+
+#endif // !GENERALIZED_SUFFIX_TREE_HPP
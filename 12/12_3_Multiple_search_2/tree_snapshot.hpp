@@ -0,0 +1,318 @@
+#pragma once
+#ifndef TREE_SNAPSHOT_HPP
+#define TREE_SNAPSHOT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // !_WIN32
+
+/*
+  Persistent suffix tree.
+  Nodes refer to each other and to text by indices only, so the node array is written as is
+  and queries run directly on the memory mapped file, without rebuilding the tree.
+
+  Layout (native byte order, every section starts at an 8-byte boundary):
+    SnapshotHeader
+    text              header.text_size bytes, including the terminator
+    nodes             header.nodes_num SnapshotNode records
+    inclusion nums    header.nodes_num uint64_t values, number of leaves under every node
+*/
+
+class TreeSnapshotException : public std::exception {
+public:
+    explicit TreeSnapshotException(const std::string& _path, const std::string& _msg) noexcept : std::exception() {
+        std::stringstream ss;
+        ss << _msg << "\nSnapshot: " << _path;
+        msg = ss.str();
+    }
+    const char* what() const noexcept override {
+        return msg.c_str();
+    }
+private:
+    std::string msg;
+};
+
+static const uint32_t SNAPSHOT_VERSION = 2;
+static const char SNAPSHOT_MAGIC[8] = { 'S', 'U', 'F', 'T', 'R', 'E', 'E', '\1' };
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t text_size;
+    uint64_t nodes_num;
+    uint64_t text_offset;
+    uint64_t nodes_offset;
+    uint64_t inclusions_offset;
+    uint64_t file_size;
+    uint64_t checksum; // FNV-1a over the whole file with this field zeroed
+};
+
+// same fields as a tree node, r is meaningless for leaves, which are non-root nodes without children
+struct SnapshotNode {
+    uint32_t l;
+    uint32_t r;
+    uint32_t first_child;
+    uint32_t next_sibling;
+};
+
+class TreeSnapshot {
+public:
+    static constexpr size_t INF = std::numeric_limits<size_t>::max();
+
+    TreeSnapshot(const TreeSnapshot&) = delete;
+    TreeSnapshot& operator = (const TreeSnapshot&) = delete;
+    TreeSnapshot(TreeSnapshot&& rhs) noexcept { *this = std::move(rhs); }
+    TreeSnapshot& operator = (TreeSnapshot&& rhs) noexcept {
+        std::swap(data, rhs.data);
+        std::swap(data_size, rhs.data_size);
+        std::swap(buffer, rhs.buffer);
+        return *this;
+    }
+    ~TreeSnapshot() {
+#ifndef _WIN32
+        if (data && buffer.empty()) {
+            munmap(const_cast<char*>(data), data_size);
+        }
+#endif // !_WIN32
+    }
+
+    /*
+      Serialize a built tree: text with its terminator, nodes of any indexable container
+      with l, r, first_child and next_sibling fields, and leaves count of every node
+    */
+    template <typename Nodes>
+    static void write(const std::string& path, const std::string& text, const Nodes& nodes, size_t nodes_num,
+                      const std::vector<size_t>& inclusion_nums) {
+        const uint64_t n = text.size();
+        SnapshotHeader header{};
+        std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+        header.version = SNAPSHOT_VERSION;
+        header.text_size = n;
+        header.nodes_num = nodes_num;
+        set_layout(header);
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw TreeSnapshotException(path, "Cannot open snapshot for writing");
+        }
+        uint64_t checksum = fnv1a(FNV_OFFSET, reinterpret_cast<const char*>(&header), sizeof(header));
+        const auto put = [&](const void* src, size_t size) {
+            out.write(static_cast<const char*>(src), size);
+            checksum = fnv1a(checksum, static_cast<const char*>(src), size);
+        };
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        put(text.data(), text.size());
+        const char padding[8] = { 0 };
+        put(padding, header.nodes_offset - header.text_offset - n);
+
+        static const size_t CHUNK = 1 << 16;
+        std::vector<SnapshotNode> node_chunk;
+        std::vector<uint64_t> inclusion_chunk;
+        for (size_t i = 0; i < nodes_num; i += CHUNK) {
+            node_chunk.clear();
+            for (size_t j = i; j < std::min(nodes_num, i + CHUNK); ++j) {
+                const auto& node = nodes[j];
+                node_chunk.push_back({ node.l, node.r, node.first_child, node.next_sibling });
+            }
+            put(node_chunk.data(), node_chunk.size() * sizeof(SnapshotNode));
+        }
+        for (size_t i = 0; i < nodes_num; i += CHUNK) {
+            inclusion_chunk.assign(inclusion_nums.begin() + i, inclusion_nums.begin() + std::min(nodes_num, i + CHUNK));
+            put(inclusion_chunk.data(), inclusion_chunk.size() * sizeof(uint64_t));
+        }
+        header.checksum = checksum;
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (!out) {
+            throw TreeSnapshotException(path, "Failed to write snapshot");
+        }
+    }
+
+    /*
+      Map a snapshot into memory. Layout and nodes are checked on every load, one pass over nodes
+      is enough to keep walks inside the file and out of loops. Damaged text or leaf counts
+      can't be told from valid ones that way, they are found only by the checksum. Checksum
+      verification reads every byte of the file, so it is optional and meant for a first open
+      after copying a snapshot around.
+    */
+    static TreeSnapshot load(const std::string& path, bool verify = false) {
+        TreeSnapshot snapshot;
+        snapshot.map(path);
+        if (snapshot.data_size < sizeof(SnapshotHeader)) {
+            throw TreeSnapshotException(path, "File is too small to be a snapshot");
+        }
+        const auto& header = snapshot.header();
+        if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 || header.version != SNAPSHOT_VERSION) {
+            throw TreeSnapshotException(path, "Unknown snapshot format");
+        }
+        // sections must be exactly where write puts them, otherwise a damaged header sends readers out of the file
+        if (header.nodes_num == 0 || header.text_size > snapshot.data_size || header.nodes_num > snapshot.data_size / sizeof(SnapshotNode)) {
+            throw TreeSnapshotException(path, "Snapshot is truncated or its header is damaged");
+        }
+        SnapshotHeader expected = header;
+        set_layout(expected);
+        if (expected.file_size != snapshot.data_size || header.file_size != snapshot.data_size || header.text_offset != expected.text_offset
+            || header.nodes_offset != expected.nodes_offset || header.inclusions_offset != expected.inclusions_offset) {
+            throw TreeSnapshotException(path, "Snapshot is truncated or its header is damaged");
+        }
+        if (!snapshot.nodes_are_valid()) {
+            throw TreeSnapshotException(path, "Snapshot nodes are damaged");
+        }
+        if (verify) {
+            SnapshotHeader unsigned_header = header;
+            unsigned_header.checksum = 0;
+            const auto checksum = fnv1a(FNV_OFFSET, reinterpret_cast<const char*>(&unsigned_header), sizeof(SnapshotHeader));
+            const auto payload = snapshot.data + sizeof(SnapshotHeader);
+            if (fnv1a(checksum, payload, snapshot.data_size - sizeof(SnapshotHeader)) != header.checksum) {
+                throw TreeSnapshotException(path, "Snapshot checksum mismatch");
+            }
+        }
+        return snapshot;
+    }
+
+    // node, which edge the word ends at, INF if the word is not in text
+    size_t walk_word(std::string_view word) const {
+        const auto text = this->text();
+        const auto nodes = this->nodes();
+        size_t node_index = 0;
+        size_t depth = 0;
+        for (const auto ch : word) {
+            if (get_node_length(node_index) == depth) {
+                auto child = nodes[node_index].first_child;
+                for (; child && text[nodes[child].l] < ch; child = nodes[child].next_sibling);
+                if (!child || text[nodes[child].l] != ch) {
+                    return INF;
+                }
+                node_index = child;
+                depth = 0;
+            } else if (text[nodes[node_index].l + depth] != ch) {
+                return INF;
+            }
+            ++depth;
+        }
+        return node_index;
+    }
+
+    size_t get_inclusion_nums(std::string_view word) const {
+        const auto node_index = walk_word(word);
+        return node_index < INF ? inclusion_nums()[node_index] : 0;
+    }
+
+    std::string_view text() const { return { data + header().text_offset, header().text_size }; }
+
+private:
+    TreeSnapshot() = default;
+
+    static const uint64_t FNV_OFFSET = 14695981039346656037ull;
+    static const uint64_t FNV_PRIME = 1099511628211ull;
+
+    static uint64_t fnv1a(uint64_t hash, const char* src, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ static_cast<unsigned char>(src[i])) * FNV_PRIME;
+        }
+        return hash;
+    }
+
+    static uint64_t align(uint64_t offset) {
+        return (offset + 7) & ~uint64_t(7);
+    }
+
+    // section offsets and file size for text_size and nodes_num of a header
+    static void set_layout(SnapshotHeader& header) {
+        header.text_offset = sizeof(SnapshotHeader);
+        header.nodes_offset = align(header.text_offset + header.text_size);
+        header.inclusions_offset = header.nodes_offset + header.nodes_num * sizeof(SnapshotNode);
+        header.file_size = header.inclusions_offset + header.nodes_num * sizeof(uint64_t);
+    }
+
+    const SnapshotHeader& header() const { return *reinterpret_cast<const SnapshotHeader*>(data); }
+    const SnapshotNode* nodes() const { return reinterpret_cast<const SnapshotNode*>(data + header().nodes_offset); }
+    const uint64_t* inclusion_nums() const { return reinterpret_cast<const uint64_t*>(data + header().inclusions_offset); }
+
+    /*
+      Links point to existing nodes, edges are non-empty and lie within text, root is empty.
+      Siblings go in strictly increasing order of their first chars, which also rules out loops in children lists.
+    */
+    bool nodes_are_valid() const {
+        const auto text = this->text();
+        const auto nodes = this->nodes();
+        const size_t nodes_num = header().nodes_num;
+        if (nodes[0].l != 0 || nodes[0].r != 0) {
+            return false;
+        }
+        for (size_t i = 0; i < nodes_num; ++i) {
+            const auto& node = nodes[i];
+            if (node.first_child >= nodes_num || node.next_sibling >= nodes_num) {
+                return false;
+            }
+            if (i && (node.l >= text.size() || (node.first_child && (node.r <= node.l || node.r > text.size())))) {
+                return false;
+            }
+        }
+        for (size_t i = 1; i < nodes_num; ++i) {
+            const auto sibling = nodes[i].next_sibling;
+            if (sibling && text[nodes[sibling].l] <= text[nodes[i].l]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // leaves go on to the end of text, which is terminated, so no word walks past it
+    size_t get_node_length(size_t node_index) const {
+        const auto& node = nodes()[node_index];
+        const size_t end = (node_index && !node.first_child) ? header().text_size : node.r;
+        return end - node.l;
+    }
+
+    void map(const std::string& path) {
+#ifndef _WIN32
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw TreeSnapshotException(path, "Cannot open snapshot");
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            throw TreeSnapshotException(path, "Cannot stat snapshot");
+        }
+        void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) {
+            throw TreeSnapshotException(path, "Cannot map snapshot");
+        }
+        data = static_cast<const char*>(mapped);
+        data_size = st.st_size;
+#else
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) {
+            throw TreeSnapshotException(path, "Cannot open snapshot");
+        }
+        data_size = static_cast<size_t>(in.tellg());
+        buffer.resize((data_size + 7) / 8);
+        in.seekg(0);
+        in.read(reinterpret_cast<char*>(buffer.data()), data_size);
+        data = reinterpret_cast<const char*>(buffer.data());
+#endif // !_WIN32
+    }
+
+    const char* data = nullptr;
+    size_t data_size = 0;
+    std::vector<uint64_t> buffer; // used instead of a mapping where mmap is not available
+};
+
+#endif // !TREE_SNAPSHOT_HPP
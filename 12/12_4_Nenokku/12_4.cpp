@@ -1,224 +1,143 @@
-﻿/*
-Theory
-Probably, the best explanation of Ukkonen's algorithm:
-https://stackoverflow.com/questions/9452701/ukkonens-suffix-tree-algorithm-in-plain-english/9513423#9513423
-
-Though, it doesn't cover all details, which are described further:
-https://stackoverflow.com/questions/9452701/ukkonens-suffix-tree-algorithm-in-plain-english/14580102#14580102
-
-For easier understanding of building tree process there is also an
-awesome visualizer of Ukkonen's tree step-by-step: https://brenden.github.io/ukkonen-animation/
-*/
-#include <iostream>
+﻿#include <iostream>
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <unordered_map>
 #include <algorithm>
 #include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+
+#include "../../common/fast_io.hpp"
+#include "../../common/suffix_tree.hpp"
+#include "../../common/cli_args.hpp"
 
 #ifdef _DEBUG
 #include "memcheck_crt.h"
 #endif // _DEBUG
 
-class Tree {
-public:
-    static const size_t INF = std::numeric_limits<size_t>::max();
-
-protected:
-    struct Node {
-        explicit Node(size_t _l) : l(_l) {}
-        explicit Node(size_t _l, size_t _r) : l(_l), r(_r) {}
-        size_t l = 0;
-        size_t r = INF;
-        size_t suff_link = 0;
-        std::unordered_map<char, size_t> edges;
-    };
+class SolverTree : public Tree {
 public:
-    Tree(std::string& _text) : text(_text) {}
+    SolverTree() : Tree(text) {}
 
-    /*
-      Build a tree. Function is online, so whenever you extend text, you can continue building a tree calling this function
-      except for case when string is terminated.
-    */
-    void build() {
-        assert(!terminated);
-        nodes.reserve(text.size() * 2);
-        for (; text_length < text.size(); ++text_length) {
-            extend();
-#ifdef _DEBUG
-            //pretty_print();
-#endif // _DEBUG
+    size_t walk_word(const std::string& word) const {
+        size_t node_index = 0;
+        size_t ch_pos = 0;
+        size_t depth = 0;
+        while (ch_pos < word.size()) {
+            const auto& node = nodes[node_index];
+            auto ch = word[ch_pos];
+            if (get_node_length(node_index) == depth) {
+                node_index = find_child(node_index, ch);
+                if (!node_index) {
+                    return INF;
+                }
+                depth = 0;
+            } else if (text[node.l + depth] != ch) {
+                return INF;
+            }
+            ++depth;
+            ++ch_pos;
         }
+        return node_index;
     }
 
-protected:
-    size_t get_node_length(const Node& node) {
-        return std::min(node.r, text_length + 1) - node.l;
-    }
+public:
+    std::string text;
+};
 
-private:
-    char active_edge_char() const {
-        return text[active_edge_index];
+/*
+  Tree built by one thread and read by others at the same time. The writer appends a chunk
+  to its own text for building and to chars, which never move, then builds and publishes the new length.
+  Readers don't take any lock the build holds: they read published chars only, chars beyond are not
+  written yet or may be written while they read, and walk again if an edge split overlapped their walk.
+*/
+class SharedTree : public BasicTree<uint32_t, char, true> {
+public:
+    SharedTree() : BasicTree(text) {
+        // no table moves under readers, untouched pages of the tables take no memory
+        reserve(MAX_TEXT_SIZE);
+        chars.reserve(MAX_TEXT_SIZE);
     }
 
-    void add_suffix_link(size_t node_index) {
-        if (need_sl_index > 0) {
-            nodes[need_sl_index].suff_link = node_index;
+    // writer thread only, the text must stay shorter than MAX_TEXT_SIZE
+    void append(std::string_view chunk) {
+        for (const auto ch : chunk) {
+            chars.emplace_back(ch);
         }
-        need_sl_index = node_index;
+        text += chunk;
+        build();
+        published.store(text.size(), std::memory_order_release);
     }
 
-    bool walk_down(size_t node_index) {
-        auto edge_length = get_node_length(nodes[node_index]);
-        if (active_node_length < edge_length) {
-            return false;
-        }
-        active_edge_index += edge_length;
-        active_node_length -= edge_length;
-        active_node_index = node_index;
-        return true;
+    size_t published_length() const {
+        return published.load(std::memory_order_acquire);
     }
 
-    void extend() {
-        need_sl_index = 0;
-        ++remainder;
-        while (remainder) {
-            if (active_node_length == 0) {
-                active_edge_index = text_length;
-            }
-            auto& edges = nodes[active_node_index].edges;
-            const auto edge_char = active_edge_char();
-            const auto& search_iter_ch = edges.find(edge_char);
-            if (search_iter_ch == edges.end()) {
-                nodes.emplace_back(text_length);
-                edges[edge_char] = nodes.size() - 1;
-                add_suffix_link(active_node_index);
-            } else {
-                const auto edge_index = (*search_iter_ch).second;
-                // Observation 1:
-                // When the final suffix we need to insert is found to exist in the tree already, 
-                // the tree itself is not changed at all(we only update the active point and remainder)
-                if (walk_down(edge_index)) {
-                    continue;
-                }
-
-                auto& edge_left_pos = nodes[edge_index].l;
-                const auto edge_right_pos = edge_left_pos + active_node_length;
-                // Observation 2
-                // If at some point active_length is greater or equal to the length of current edge (edge_length), 
-                // we move our active point down until edge_length is strictly greater than active_length.
-                const auto cur_char = text[text_length];
-                if (text[edge_right_pos] == cur_char) {
-                    ++active_node_length;
-                    // Observation 3
-                    // When the symbol we want to add to the tree is already on the edge, we, according to Observation 1,
-                    // update only active point and remainder, leaving the tree unchanged.
-                    // BUT if there is an internal node marked as needing suffix link,
-                    // we must connect that node with our current active node through a suffix link.
-                    add_suffix_link(active_node_index);
-                    break;
-                }
-                auto& mid_node = nodes.emplace_back(edge_left_pos, edge_right_pos); // Add a new middle node
-                const auto mid_index = nodes.size() - 1;
-                nodes[active_node_index].edges[active_edge_char()] = mid_index; // Relink active node edge to middle node
-                nodes.emplace_back(text_length); // Add a new leaf node
-                auto& mid_node_edges = mid_node.edges;
-                mid_node_edges[cur_char] = nodes.size() - 1; // Add mid_node-new_leaf link
-                edge_left_pos += active_node_length;
-                mid_node_edges[text[edge_left_pos]] = edge_index; // Add mid_node-old_leaf link
-                // Rule 2
-                // If we create a new internal node OR make an inserter from an internal node, 
-                // and this is not the first SUCH internal node at current step, 
-                // then we link the previous SUCH node with THIS one through a suffix link.
-                add_suffix_link(mid_index);
+    /*
+      Any thread: whether word occurs in the first prefix_length <= published_length() chars of text,
+      the tree may be built further meanwhile.
+    */
+    bool occurs_in_prefix(const std::string& word, size_t prefix_length) const {
+        while (true) {
+            const auto version = splits_version.load(std::memory_order_acquire);
+            if (version & 1) {
+                std::this_thread::yield();
+                continue;
             }
-            --remainder;
-            if (active_node_index == 0 && active_node_length > 0) {
-                // Rule 1
-                // If after an insertion from the active node = root, the active length is greater than 0, then:
-                // 1. active node is not changed
-                // 2. active length is decremented
-                // 3. active edge is shifted right(to the first character of the next suffix we must insert)
-                --active_node_length;
-                active_edge_index = text_length - remainder + 1;
-            } else {
-                // Rule 3
-                // After an insert from the active node which is not the root node,
-                // we must follow the suffix linkand set the active node to the node it points to.
-                // If there is no a suffix link, set the active node to the root node.
-                // Either way, active edge and active length stay unchanged.
-                active_node_index = nodes[active_node_index].suff_link;
+            const bool found = walk_prefix(word, prefix_length);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (splits_version.load(std::memory_order_relaxed) == version) {
+                return found;
             }
         }
     }
 
-    void pretty_print(size_t node_index, std::string pad) {
-        const auto& node = nodes[node_index];
-        const auto node_length = get_node_length(node);
-        const std::string delim = " ";
-        const std::string suff_str = node.suff_link ? "(" + std::to_string(node.suff_link) + ")" : "";
-        std::cout << pad << node_index << suff_str << delim << text.substr(node.l, node_length) << "\n";
-        pad = "  " + pad;
-        for (const auto& [_, val] : node.edges) {
-            pretty_print(val, pad);
-        }
-    }
-
-    void pretty_print() {
-        std::cout << text.substr(0, text_length + 1) << "\n";
-        std::cout << "active index=" << active_node_index << " edge=" << active_edge_char() << " length=" << active_node_length << "\n";
-        pretty_print(0, "");
-        std::cout << "\n";
-    }
-
-protected:
-    bool terminated = false;
-    size_t need_sl_index = 0; // node, that needs a suffix link
-    size_t active_node_index = 0; // index of active node
-    size_t active_edge_index = 0; // index of active edge char in text
-    size_t active_node_length = 0; // distance between current position and beggining of active node position
-    size_t remainder = 0; // how many leafs to add to make tree completed (with active_node_length=0)
-    size_t text_length = 0; // length of processed text
-    std::string& text;
-    std::vector<Node> nodes{ Node(0, 0) };
-};
-
-
-class SolverTree : public Tree {
-public:
-    SolverTree() : Tree(text) {}
-
-    size_t walk_word(const std::string& word) {
+private:
+    /*
+      A node appears together with the first occurrence of its path, which starts at l of the node
+      minus depth of its parent; splits move l and the parent depth by the same amount.
+      So a char at prefix_length or beyond on the path means the first occurrence doesn't fit,
+      and children starting there can be skipped without reading their chars.
+    */
+    bool walk_prefix(const std::string& word, size_t prefix_length) const {
         size_t node_index = 0;
-        size_t ch_pos = 0;
+        size_t node_l = 0;
+        size_t node_length = 0;
+        size_t parent_depth = 0;
         size_t depth = 0;
-        while (ch_pos < word.size()) {
-            auto& node = nodes[node_index];
-            auto ch = word[ch_pos];
-            if (get_node_length(node) == depth) {
-                const auto& edges = node.edges;
-                const auto& search_iter_ch = edges.find(ch);
-                if (search_iter_ch == edges.end()) {
-                    return INF;
+        for (const auto ch : word) {
+            if (depth == node_length) {
+                parent_depth += depth;
+                size_t child = nodes[node_index].first_child;
+                size_t child_l = 0;
+                for (; child; child = nodes[child].next_sibling) {
+                    child_l = nodes[child].l;
+                    if (child_l < prefix_length && chars[child_l] >= ch) {
+                        break;
+                    }
+                }
+                if (!child || chars[child_l] != ch) {
+                    return false;
                 }
-                node_index = (*search_iter_ch).second;
+                node_index = child;
+                node_l = child_l;
+                node_length = is_leaf(child) ? INF : nodes[child].r - child_l;
                 depth = 0;
-            } else if (text[node.l + depth] != ch) {
-                return INF;
+            } else if (node_l + depth >= prefix_length || chars[node_l + depth] != ch) {
+                return false;
             }
             ++depth;
-            ++ch_pos;
         }
-        return node_index;
+        return node_l - parent_depth + word.size() <= prefix_length;
     }
 
-    void reserve(size_t text_size) {
-        nodes.reserve(text_size * 2);
-    }
-
-public:
-    std::string text;
+    std::string text; // building copy, written by the writer only
+    SegmentedPool<char> chars; // the same text for readers
+    std::atomic<size_t> published{ 0 };
 };
 
 
@@ -229,16 +148,18 @@ void solve_nenokku() {
     std::string line;
     std::string word;
     const size_t w_start = 2;
-    while (std::getline(std::cin, line)) {
+    FastReader in(std::cin);
+    FastWriter out(std::cout);
+    while (in.getline(line)) {
         action = line[0];
         if (action == '?') {
             if (line.size() <= w_start) {
-                std::cout << "YES\n";
+                out << "YES\n";
                 continue;
             }
             word.resize(line.size() - w_start);
             std::transform(line.begin() + w_start, line.end(), word.begin(), tolower);
-            std::cout << ((utree.walk_word(word) != Tree::INF) ? "YES\n" : "NO\n");
+            out << ((utree.walk_word(word) != Tree::INF) ? "YES\n" : "NO\n");
         } else {
             if (line.size() <= w_start) {
                 continue;
@@ -251,13 +172,142 @@ void solve_nenokku() {
     }
 }
 
-int main() {
+/*
+  Service mode: requests are read as they arrive, a writer thread extends the tree
+  while reader threads answer queries. A query must see exactly the text appended before it
+  in the input. Readers may find the tree ahead of that, so the answer is limited to the query's
+  text length; a query is picked up once that length is published.
+  Builds and queries don't wait for each other, see SharedTree; the mutex guards request queues only.
+  Answers are printed in input order and flushed as soon as the next one in order is ready.
+*/
+void solve_nenokku_service(size_t threads_num) {
+    struct Query {
+        std::string word;
+        size_t text_length;
+        size_t id;
+    };
+    SharedTree tree;
+
+    std::mutex requests_mutex; // guards the queues and input_done, published lengths are waited for under it
+    std::condition_variable requests_cv;
+    std::deque<std::string> appends;
+    std::deque<Query> queries;
+    bool input_done = false;
+
+    std::mutex answers_mutex; // guards answers, printed and out
+    std::deque<char> answers; // 0 until answered, answers of queries from printed on
+    size_t printed = 0;
+    FastWriter out(std::cout);
+
+    std::thread writer([&] {
+        std::unique_lock<std::mutex> lock(requests_mutex);
+        while (true) {
+            requests_cv.wait(lock, [&] { return !appends.empty() || input_done; });
+            if (appends.empty()) {
+                return;
+            }
+            const auto chunk = std::move(appends.front());
+            appends.pop_front();
+            lock.unlock();
+            tree.append(chunk);
+            lock.lock(); // so a reader can't miss the notification between its check and its wait
+            requests_cv.notify_all();
+        }
+    });
+
+    const auto answer = [&] {
+        std::unique_lock<std::mutex> lock(requests_mutex);
+        while (true) {
+            // text lengths of queries don't decrease, so only the front one may become ready
+            requests_cv.wait(lock, [&] {
+                return (!queries.empty() && queries.front().text_length <= tree.published_length()) || (queries.empty() && input_done);
+            });
+            if (queries.empty()) {
+                return;
+            }
+            const auto query = std::move(queries.front());
+            queries.pop_front();
+            lock.unlock();
+            const bool found = tree.occurs_in_prefix(query.word, query.text_length);
+            {
+                std::lock_guard<std::mutex> out_lock(answers_mutex);
+                answers[query.id - printed] = found ? 2 : 1;
+                if (query.id == printed) {
+                    for (; !answers.empty() && answers.front(); answers.pop_front(), ++printed) {
+                        out << (answers.front() == 2 ? "YES\n" : "NO\n");
+                    }
+                    out.flush();
+                }
+            }
+            lock.lock();
+        }
+    };
+    std::vector<std::thread> readers;
+    for (size_t t = 0; t < threads_num; ++t) {
+        readers.emplace_back(answer);
+    }
+
+    LineReader in(std::cin);
+    std::string line;
+    const size_t w_start = 2;
+    size_t text_length = 0;
+    size_t queries_num = 0;
+    while (in.getline(line)) {
+        std::string word(line.size() > w_start ? line.size() - w_start : 0, ' ');
+        std::transform(line.end() - word.size(), line.end(), word.begin(), tolower);
+        if (line[0] == '?') {
+            {
+                std::lock_guard<std::mutex> out_lock(answers_mutex);
+                answers.push_back(0);
+            }
+            std::lock_guard<std::mutex> lock(requests_mutex);
+            queries.push_back({ std::move(word), text_length, queries_num++ });
+        } else if (!word.empty()) {
+            if (text_length + word.size() >= SharedTree::MAX_TEXT_SIZE) {
+                std::cerr << "Text is too long for the suffix tree index type, the rest of input is skipped\n";
+                break;
+            }
+            text_length += word.size();
+            std::lock_guard<std::mutex> lock(requests_mutex);
+            appends.push_back(std::move(word));
+        } else {
+            continue;
+        }
+        requests_cv.notify_all();
+    }
+    {
+        std::lock_guard<std::mutex> lock(requests_mutex);
+        input_done = true;
+    }
+    requests_cv.notify_all();
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    writer.join();
+}
+
+/*
+  Usage:
+    app                              lines "? word" and "A text" from stdin are processed one by one
+    app --service [--threads N]      requests are streamed, appends run in a writer thread, queries are answered by N reader threads
+*/
+int main(int argc, char* argv[]) {
 #ifdef _DEBUG
     ENABLE_CRT;
     std::ifstream input_stream("input.txt");
     std::cin.rdbuf(input_stream.rdbuf());
 #endif // _DEBUG
     std::ios::sync_with_stdio(false), std::cin.tie(0), std::cout.tie(0);
+    const std::vector<std::string> args(argv + 1, argv + argc);
+    if (has_flag(args, "--service")) {
+        const auto threads_num = get_threads_num(args);
+        if (!threads_num) {
+            std::cerr << THREADS_ERROR << "\n";
+            return EXIT_FAILURE;
+        }
+        solve_nenokku_service(*threads_num);
+        return EXIT_SUCCESS;
+    }
     solve_nenokku();
     return EXIT_SUCCESS;
 }
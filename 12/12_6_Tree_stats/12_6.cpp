@@ -0,0 +1,73 @@
+/*
+  Statistics of a suffix tree built for every input: shape of the tree, memory it takes
+  and what extend() was busy with. One line per input as space separated key=value pairs.
+*/
+#define SUFFIX_TREE_STATS
+
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+#include "../../common/suffix_tree.hpp"
+
+#ifdef _DEBUG
+#include "memcheck_crt.h"
+#endif // _DEBUG
+
+class StatsTree : public Tree {
+public:
+    StatsTree() : Tree(text) {}
+
+public:
+    std::string text;
+};
+
+void print_stats(const std::string& name, std::istream& in) {
+    StatsTree tree;
+    tree.text.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    const auto start = std::chrono::steady_clock::now();
+    tree.build();
+    const auto build_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    const auto stats = tree.get_stats();
+    const auto chars = std::max<size_t>(1, stats.text_length);
+    std::cout << "stats input=" << name << " chars=" << stats.text_length
+              << " nodes=" << stats.nodes << " internal=" << stats.internal_nodes << " leaves=" << stats.leaves
+              << " fanout=" << stats.average_fanout
+              << " node_bytes=" << stats.node_bytes << " suffix_link_bytes=" << stats.suffix_link_bytes
+              << " node_bytes_used=" << stats.node_bytes_used << " suffix_link_bytes_used=" << stats.suffix_link_bytes_used
+              << " bytes_per_char=" << static_cast<double>(stats.node_bytes_used + stats.suffix_link_bytes_used) / chars
+              << " walk_down_skips=" << stats.walk_down_skips << " suffix_link_follows=" << stats.suffix_link_follows
+              << " splits=" << stats.splits
+              << " build_ms=" << build_ms << " ms_per_mchar=" << build_ms * 1e6 / chars << "\n";
+}
+
+/*
+  Usage:
+    app [FILE...]    text of every file is taken as is, stdin if there are no files
+*/
+int main(int argc, char* argv[]) {
+#ifdef _DEBUG
+    ENABLE_CRT;
+    std::ifstream input_stream("input.txt");
+    std::cin.rdbuf(input_stream.rdbuf());
+#endif // _DEBUG
+    std::ios::sync_with_stdio(false), std::cin.tie(0), std::cout.tie(0);
+    if (argc < 2) {
+        print_stats("stdin", std::cin);
+        return EXIT_SUCCESS;
+    }
+    for (int i = 1; i < argc; ++i) {
+        std::ifstream in(argv[i], std::ios::binary);
+        if (!in) {
+            std::cerr << "Cannot open " << argv[i] << "\n";
+            return EXIT_FAILURE;
+        }
+        print_stats(argv[i], in);
+    }
+    return EXIT_SUCCESS;
+}
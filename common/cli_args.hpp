@@ -0,0 +1,44 @@
+#pragma once
+#ifndef CLI_ARGS_HPP
+#define CLI_ARGS_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+  Command line flags shared by the string tools, args are argv without the program name
+*/
+
+inline bool has_flag(const std::vector<std::string>& args, const std::string& flag) {
+    return std::find(args.begin(), args.end(), flag) != args.end();
+}
+
+// argument after the flag, default_value if there is no such flag or it is the last argument
+inline std::string get_flag_value(const std::vector<std::string>& args, const std::string& flag, const std::string& default_value) {
+    const auto it = std::find(args.begin(), args.end(), flag);
+    if (it == args.end() || std::next(it) == args.end()) {
+        return default_value;
+    }
+    return *std::next(it);
+}
+
+static const size_t MAX_THREADS = 1024;
+static const char* const THREADS_ERROR = "--threads expects a number from 0 (all hardware threads) to 1024";
+
+// --threads N, all hardware threads without the flag or with N = 0, nullopt if N is not a number in [0, MAX_THREADS]
+inline std::optional<size_t> get_threads_num(const std::vector<std::string>& args) {
+    const auto value = get_flag_value(args, "--threads", "0");
+    size_t threads_num = 0;
+    const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), threads_num);
+    if (error != std::errc() || end != value.data() + value.size() || threads_num > MAX_THREADS) {
+        return std::nullopt;
+    }
+    // hardware_concurrency may be 0 when it is unknown
+    return threads_num ? threads_num : std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+#endif // !CLI_ARGS_HPP
@@ -0,0 +1,117 @@
+#pragma once
+#ifndef COMPRESSED_LCP_HPP
+#define COMPRESSED_LCP_HPP
+
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+/*
+  LCP array with one byte per entry. Values from ESCAPE up are marked with ESCAPE and kept
+  in an exception table sorted by index. On natural text long common prefixes are rare,
+  so the array takes a bit more than n bytes instead of n words.
+  Reading a byte is O(1), an escaped value is found by binary search over the exceptions,
+  Scanner reads in index order with no search at all.
+  Highly periodic texts are the opposite case: almost every value is an exception and takes two words.
+  Once exceptions exceed a quarter of entries, the array switches to plain words,
+  so it never takes more than about 5 bytes per entry before the switch and a word after it.
+*/
+class CompressedLcp {
+public:
+    static const uint8_t ESCAPE = 255;
+    static const size_t PLAIN_SHARE = 4; // switch to plain words at size / PLAIN_SHARE exceptions
+
+    CompressedLcp() = default;
+    explicit CompressedLcp(size_t n) : small(n) {}
+    explicit CompressedLcp(const std::vector<size_t>& lcp) : small(lcp.size()) {
+        for (size_t i = 0; i < lcp.size(); ++i) {
+            set(i, lcp[i]);
+        }
+        finish();
+    }
+
+    /*
+      Values may be set in any order (Kasai fills lcp in text order),
+      finish must be called once after the last one
+    */
+    void set(size_t i, size_t value) {
+        if (plain_words) {
+            plain[i] = value;
+            return;
+        }
+        if (value < ESCAPE) {
+            small[i] = static_cast<uint8_t>(value);
+            return;
+        }
+        small[i] = ESCAPE;
+        exceptions.emplace_back(i, value);
+        if (exceptions.size() > small.size() / PLAIN_SHARE) {
+            to_plain();
+        }
+    }
+
+    void finish() {
+        std::sort(exceptions.begin(), exceptions.end());
+    }
+
+    size_t operator[](size_t i) const {
+        if (plain_words) {
+            return plain[i];
+        }
+        if (small[i] != ESCAPE) {
+            return small[i];
+        }
+        return std::lower_bound(exceptions.begin(), exceptions.end(), std::make_pair(i, size_t(0)))->second;
+    }
+
+    size_t size() const { return plain_words ? plain.size() : small.size(); }
+    bool is_plain() const { return plain_words; }
+    size_t exceptions_count() const { return exceptions.size(); }
+    size_t bytes() const {
+        return plain.size() * sizeof(size_t) + small.size() * sizeof(uint8_t) + exceptions.size() * sizeof(exceptions[0]);
+    }
+
+    /*
+      Reads at non-decreasing indices: the exception table is walked with a pointer instead of searched,
+      so a full scan is O(n) even when most values are large
+    */
+    class Scanner {
+    public:
+        explicit Scanner(const CompressedLcp& _lcp) : lcp(_lcp) {}
+
+        size_t operator[](size_t i) {
+            if (lcp.plain_words) {
+                return lcp.plain[i];
+            }
+            if (lcp.small[i] != ESCAPE) {
+                return lcp.small[i];
+            }
+            for (; lcp.exceptions[next].first < i; ++next);
+            return lcp.exceptions[next].second;
+        }
+
+    private:
+        const CompressedLcp& lcp;
+        size_t next = 0;
+    };
+
+private:
+    // values which are not set yet are zeros in both layouts
+    void to_plain() {
+        plain.assign(small.begin(), small.end());
+        for (const auto& [i, value] : exceptions) {
+            plain[i] = value;
+        }
+        std::vector<uint8_t>().swap(small);
+        std::vector<std::pair<size_t, size_t>>().swap(exceptions);
+        plain_words = true;
+    }
+
+    bool plain_words = false;
+    std::vector<uint8_t> small;
+    std::vector<std::pair<size_t, size_t>> exceptions; // (index, value)
+    std::vector<size_t> plain; // every value as is, once exceptions are too many
+};
+
+#endif // !COMPRESSED_LCP_HPP
@@ -0,0 +1,209 @@
+#pragma once
+#ifndef FAST_IO_HPP
+#define FAST_IO_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/*
+  Reads the whole stream into memory with bulk sgetn calls, then tokens are cut from the buffer.
+  Works on top of std::istream, so input redirected with rdbuf (input.txt in _DEBUG) keeps working.
+  The constructor returns only at the end of input, interactive modes read with LineReader instead.
+*/
+class FastReader {
+public:
+    explicit FastReader(std::istream& in) {
+        static const size_t CHUNK = 1 << 16;
+        auto* buf = in.rdbuf();
+        for (;;) {
+            const auto size = data.size();
+            data.resize(size + CHUNK);
+            const auto got = static_cast<size_t>(buf->sgetn(&data[size], CHUNK));
+            data.resize(size + got);
+            if (got < CHUNK) {
+                break;
+            }
+        }
+    }
+
+    // next whitespace separated token, empty at the end of input
+    std::string_view token() {
+        skip_spaces();
+        const auto begin = pos;
+        for (; pos < data.size() && !is_space(data[pos]); ++pos);
+        return std::string_view(data).substr(begin, pos - begin);
+    }
+
+    bool read(std::string& str) {
+        const auto tok = token();
+        str.assign(tok.data(), tok.size());
+        return !tok.empty();
+    }
+
+    // false at the end of input or if the next token is not a number
+    template <typename T, typename = std::enable_if_t<std::is_integral_v<T>>>
+    bool read(T& value) {
+        skip_spaces();
+        if (pos >= data.size()) {
+            return false;
+        }
+        const bool negative = data[pos] == '-';
+        pos += negative ? 1 : 0;
+        const auto digits_begin = pos;
+        std::make_unsigned_t<T> result = 0;
+        for (; pos < data.size() && data[pos] >= '0' && data[pos] <= '9'; ++pos) {
+            result = result * 10 + (data[pos] - '0');
+        }
+        value = static_cast<T>(negative ? 0 - result : result);
+        return pos > digits_begin;
+    }
+
+    // line without line break, '\r' of windows line endings is dropped too
+    bool getline(std::string& line) {
+        if (pos >= data.size()) {
+            return false;
+        }
+        auto end = data.find('\n', pos);
+        end = (end == std::string::npos) ? data.size() : end;
+        auto line_end = end;
+        line_end -= (line_end > pos && data[line_end - 1] == '\r') ? 1 : 0;
+        line.assign(data, pos, line_end - pos);
+        pos = end + 1;
+        return true;
+    }
+
+private:
+    static bool is_space(char ch) { return ch == ' ' || ch == '\n' || ch == '\r' || ch == '\t'; }
+    void skip_spaces() {
+        for (; pos < data.size() && is_space(data[pos]); ++pos);
+    }
+
+    std::string data;
+    size_t pos = 0;
+};
+
+/*
+  Reads a stream line by line as it arrives, so a request can be answered before the next one is written.
+  Lines are taken from the stream buffer, which is filled by reads of whatever input is available.
+*/
+class LineReader {
+public:
+    explicit LineReader(std::istream& _in) : in(_in) {}
+
+    // line without line break, '\r' of windows line endings is dropped too
+    bool getline(std::string& line) {
+        if (!std::getline(in, line)) {
+            return false;
+        }
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        return true;
+    }
+
+    // next line is already available, so answers may be held back until it is processed
+    bool has_pending_input() const {
+        return in.rdbuf()->in_avail() > 0;
+    }
+
+private:
+    std::istream& in;
+};
+
+/*
+  Collects output in a preallocated buffer and writes it with a single call when full.
+  Integers are printed two digits at a time with a lookup table.
+  Interactive modes call flush once an answer is due, e.g. when LineReader has no pending input.
+*/
+class FastWriter {
+public:
+    explicit FastWriter(std::ostream& _out, size_t capacity = 1 << 16) : out(_out), buffer(capacity) {}
+    FastWriter(const FastWriter&) = delete;
+    FastWriter& operator = (const FastWriter&) = delete;
+    ~FastWriter() { flush(); }
+
+    FastWriter& operator << (std::string_view str) {
+        if (str.size() > buffer.size() - pos) {
+            flush();
+            if (str.size() > buffer.size()) {
+                out.write(str.data(), str.size());
+                return *this;
+            }
+        }
+        std::memcpy(&buffer[pos], str.data(), str.size());
+        pos += str.size();
+        return *this;
+    }
+
+    FastWriter& operator << (const char* str) { return *this << std::string_view(str); }
+    FastWriter& operator << (const std::string& str) { return *this << std::string_view(str); }
+
+    FastWriter& operator << (char ch) {
+        if (pos == buffer.size()) {
+            flush();
+        }
+        buffer[pos++] = ch;
+        return *this;
+    }
+
+    template <typename T, typename = std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, char> && !std::is_same_v<T, bool>>>
+    FastWriter& operator << (T value) {
+        if (buffer.size() - pos < MAX_DIGITS + 1) {
+            flush();
+        }
+        std::make_unsigned_t<T> rest = static_cast<std::make_unsigned_t<T>>(value);
+        if constexpr (std::is_signed_v<T>) {
+            if (value < 0) {
+                buffer[pos++] = '-';
+                rest = 0 - rest;
+            }
+        }
+        char digits[MAX_DIGITS];
+        size_t len = MAX_DIGITS;
+        for (; rest >= 100; rest /= 100) {
+            len -= 2;
+            std::memcpy(&digits[len], &DIGIT_PAIRS[(rest % 100) * 2], 2);
+        }
+        if (rest >= 10) {
+            len -= 2;
+            std::memcpy(&digits[len], &DIGIT_PAIRS[rest * 2], 2);
+        } else {
+            digits[--len] = static_cast<char>('0' + rest);
+        }
+        std::memcpy(&buffer[pos], &digits[len], MAX_DIGITS - len);
+        pos += MAX_DIGITS - len;
+        return *this;
+    }
+
+    void flush() {
+        out.write(buffer.data(), pos);
+        out.flush();
+        pos = 0;
+    }
+
+private:
+    static const size_t MAX_DIGITS = 20;
+    static constexpr const char* DIGIT_PAIRS =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+    std::ostream& out;
+    std::vector<char> buffer;
+    size_t pos = 0;
+};
+
+#endif // !FAST_IO_HPP
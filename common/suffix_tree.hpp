@@ -0,0 +1,468 @@
+#pragma once
+#ifndef SUFFIX_TREE_HPP
+#define SUFFIX_TREE_HPP
+
+/*
+Theory
+Probably, the best explanation of Ukkonen's algorithm:
+https://stackoverflow.com/questions/9452701/ukkonens-suffix-tree-algorithm-in-plain-english/9513423#9513423
+
+Though, it doesn't cover all details, which are described further:
+https://stackoverflow.com/questions/9452701/ukkonens-suffix-tree-algorithm-in-plain-english/14580102#14580102
+
+For easier understanding of building tree process there is also an
+awesome visualizer of Ukkonen's tree step-by-step: https://brenden.github.io/ukkonen-animation/
+*/
+#include <iostream>
+#include <string>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <stdexcept>
+#include <initializer_list>
+#include <atomic>
+#include <type_traits>
+
+/*
+  Counters of extend() events are compiled in only with SUFFIX_TREE_STATS defined,
+  otherwise they cost nothing
+*/
+#ifdef SUFFIX_TREE_STATS
+#define SUFFIX_TREE_COUNT(counter) ++build_counters.counter
+#else
+#define SUFFIX_TREE_COUNT(counter)
+#endif // SUFFIX_TREE_STATS
+
+/*
+  Vector-like storage made of fixed size segments. Growing never moves stored elements:
+  appending to a large pool costs the same as to a small one, without a copy of everything
+  once in a while, and references to elements stay valid.
+  With the segment table reserved for the largest size ahead, the table doesn't move either,
+  so other threads may read elements published to them while one thread appends.
+*/
+template <typename T, size_t SEGMENT_BITS = 16>
+class SegmentedPool {
+public:
+    static constexpr size_t SEGMENT_SIZE = size_t(1) << SEGMENT_BITS;
+
+    SegmentedPool() = default;
+
+    SegmentedPool(std::initializer_list<T> values) {
+        for (const auto& value : values) {
+            emplace_back(value);
+        }
+    }
+
+    T& operator[](size_t i) {
+        return segments[i >> SEGMENT_BITS][i & (SEGMENT_SIZE - 1)];
+    }
+
+    const T& operator[](size_t i) const {
+        return segments[i >> SEGMENT_BITS][i & (SEGMENT_SIZE - 1)];
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    // allocated memory, a started segment is allocated whole
+    size_t bytes() const {
+        return segments.size() * SEGMENT_SIZE * sizeof(T) + segments.capacity() * sizeof(segments[0]);
+    }
+
+    // memory taken by stored elements and the segment table
+    size_t used_bytes() const {
+        return count * sizeof(T) + segments.size() * sizeof(segments[0]);
+    }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+        if ((count & (SEGMENT_SIZE - 1)) == 0) {
+            segments.emplace_back();
+            segments.back().reserve(SEGMENT_SIZE);
+        }
+        segments.back().emplace_back(std::forward<Args>(args)...);
+        ++count;
+    }
+
+    // only the segment table is allocated ahead, segments are allocated as they are filled
+    void reserve(size_t n) {
+        segments.reserve((n + SEGMENT_SIZE - 1) >> SEGMENT_BITS);
+    }
+
+private:
+    std::vector<std::vector<T>> segments;
+    size_t count = 0;
+};
+
+/*
+  Node field of a tree, which other threads read while it is built. Stores release and loads acquire,
+  so a reader which got a node index from a link sees the node initialized.
+  On x86 these are plain moves, the cost is in optimizations the compiler may not do around them.
+*/
+template <typename Index>
+class SharedField {
+public:
+    explicit SharedField(Index _value = 0) : value(_value) {}
+    SharedField(const SharedField& rhs) : value(rhs) {}
+    SharedField& operator = (const SharedField& rhs) { return *this = static_cast<Index>(rhs); }
+
+    operator Index() const { return value.load(std::memory_order_acquire); }
+    SharedField& operator = (Index rhs) {
+        value.store(rhs, std::memory_order_release);
+        return *this;
+    }
+    SharedField& operator += (Index rhs) { return *this = static_cast<Index>(*this + rhs); }
+
+private:
+    std::atomic<Index> value;
+};
+
+/*
+  Index is the type of text positions and node indices. A tree has at most 2n nodes,
+  so uint32_t fits texts shorter than 2G chars and halves the memory compared to size_t.
+  Symbol is the alphabet: char for plain strings, a wider character type (char32_t) when text needs
+  more distinct symbols, e.g. a unique terminator per document. It has to be a character type,
+  std::basic_string of plain integers is not supported by every standard library.
+  SHARED_READS lets other threads walk the tree while it is built: node fields are SharedField,
+  and every edge split is done between two increments of splits_version, so a reader which saw
+  the version odd or changed during its walk may have seen a half done split and walks again.
+  Leaf insertions change one link and are seen either done or not. Readers must not use text
+  or text_length, which only the building thread may touch.
+*/
+template <typename Index, typename Symbol = char, bool SHARED_READS = false>
+class BasicTree {
+public:
+    using Text = std::basic_string<Symbol>;
+
+    // returned instead of a node index when there is no such node
+    static constexpr size_t INF = std::numeric_limits<size_t>::max();
+    static constexpr size_t MAX_TEXT_SIZE = std::numeric_limits<Index>::max() / 2;
+
+protected:
+    /*
+      Fields read on every step of extend() and walk_word. Suffix links are needed only in extend()
+      after an insertion, so they are kept in a separate array and don't take cache lines here.
+      Children of a node form a singly linked list sorted by the first char of their edges.
+      Index 0 means "no node" in child and sibling links, root is never a child of anything.
+      Leaves are the only nodes without children except the root, their edges end at the end of text,
+      so r is meaningful for inner nodes only and leaves don't need an INF mark.
+    */
+    using Field = std::conditional_t<SHARED_READS, SharedField<Index>, Index>;
+
+    struct Node {
+        explicit Node(Index _l) : l(_l) {}
+        explicit Node(Index _l, Index _r) : l(_l), r(_r) {}
+        Field l{ 0 };
+        Field r{ 0 };
+        Field first_child{ 0 };
+        Field next_sibling{ 0 };
+    };
+public:
+    BasicTree(Text& _text) : text(_text) {}
+
+    /*
+      Build a tree. Function is online, so whenever you extend text, you can continue building a tree calling this function
+      except for case when string is terminated.
+    */
+    void build() {
+        assert(!terminated);
+        if (text.size() >= MAX_TEXT_SIZE) {
+            throw std::length_error("text is too long for the suffix tree index type");
+        }
+        reserve(text.size());
+        for (; text_length < text.size(); ++text_length) {
+            extend();
+#ifdef _DEBUG
+            //pretty_print();
+#endif // _DEBUG
+        }
+    }
+
+    struct Stats {
+        size_t text_length = 0;
+        size_t nodes = 0;
+        size_t internal_nodes = 0; // root included
+        size_t leaves = 0;
+        double average_fanout = 0; // children per internal node
+        size_t node_bytes = 0; // allocated for nodes with their child lists
+        size_t suffix_link_bytes = 0;
+        size_t node_bytes_used = 0; // taken by existing nodes, the rest of the last segment is not counted
+        size_t suffix_link_bytes_used = 0;
+        // extend() events, zero unless built with SUFFIX_TREE_STATS
+        size_t walk_down_skips = 0;
+        size_t suffix_link_follows = 0;
+        size_t splits = 0;
+    };
+
+    // O(n) pass over nodes
+    Stats get_stats() const {
+        Stats stats;
+        stats.text_length = text_length;
+        stats.nodes = nodes.size();
+        for (size_t i = 0; i < nodes.size(); ++i) {
+            stats.leaves += is_leaf(i) ? 1 : 0;
+        }
+        stats.internal_nodes = stats.nodes - stats.leaves;
+        stats.average_fanout = static_cast<double>(stats.nodes - 1) / stats.internal_nodes;
+        stats.node_bytes = nodes.bytes();
+        stats.suffix_link_bytes = suff_links.bytes();
+        stats.node_bytes_used = nodes.used_bytes();
+        stats.suffix_link_bytes_used = suff_links.used_bytes();
+        stats.walk_down_skips = build_counters.walk_down_skips;
+        stats.suffix_link_follows = build_counters.suffix_link_follows;
+        stats.splits = build_counters.splits;
+        return stats;
+    }
+
+    void reserve(size_t text_size) {
+        nodes.reserve(text_size * 2);
+        suff_links.reserve(text_size * 2);
+    }
+
+protected:
+    bool is_leaf(size_t node_index) const {
+        return node_index && !nodes[node_index].first_child;
+    }
+
+    // end of the edge leading to a node, INF for leaves
+    size_t edge_end(size_t node_index) const {
+        return is_leaf(node_index) ? INF : nodes[node_index].r;
+    }
+
+    size_t get_node_length(size_t node_index) const {
+        return std::min(edge_end(node_index), text_length + 1) - nodes[node_index].l;
+    }
+
+    // first char of the edge leading to a node
+    Symbol edge_char(size_t node_index) const {
+        return text[nodes[node_index].l];
+    }
+
+    // child of a node, which edge starts with ch, 0 if there is none
+    size_t find_child(size_t node_index, Symbol ch) const {
+        auto child = nodes[node_index].first_child;
+        for (; child && edge_char(child) < ch; child = nodes[child].next_sibling);
+        return (child && edge_char(child) == ch) ? child : 0;
+    }
+
+    /*
+      Depth-first walk over the whole tree, children in order of their first char, so leaves come
+      in lexicographic order of suffixes. enter(node_index, depth) is called before children and
+      leave(node_index, depth) after them, depth is the length of the path from root to the node end.
+      No recursion: the path from root is kept in one buffer, so depth of the tree is not limited
+      by the call stack (it is linear on texts like aaa...a).
+    */
+    template <typename Enter, typename Leave>
+    void traverse(Enter&& enter, Leave&& leave) const {
+        std::vector<std::pair<size_t, size_t>> path; // ancestors of the current node with their depths
+        size_t node_index = 0;
+        size_t depth = 0;
+        while (true) {
+            enter(node_index, depth);
+            const auto child = nodes[node_index].first_child;
+            if (child) {
+                path.emplace_back(node_index, depth);
+                node_index = child;
+                depth += get_node_length(child);
+                continue;
+            }
+            leave(node_index, depth);
+            // climb up to the first ancestor which has a next sibling
+            while (true) {
+                if (path.empty()) {
+                    return;
+                }
+                const auto sibling = nodes[node_index].next_sibling;
+                if (sibling) {
+                    node_index = sibling;
+                    depth = path.back().second + get_node_length(sibling);
+                    break;
+                }
+                std::tie(node_index, depth) = path.back();
+                path.pop_back();
+                leave(node_index, depth);
+            }
+        }
+    }
+
+private:
+    Symbol active_edge_char() const {
+        return text[active_edge_index];
+    }
+
+    size_t add_node(size_t l, size_t r = 0) {
+        nodes.emplace_back(static_cast<Index>(l), static_cast<Index>(r));
+        suff_links.emplace_back(0);
+        return nodes.size() - 1;
+    }
+
+    // link in the children list of a node, where a child starting with ch is or should be
+    Field& find_child_link(size_t node_index, Symbol ch) {
+        auto* link = &nodes[node_index].first_child;
+        for (; *link && edge_char(*link) < ch; link = &nodes[*link].next_sibling);
+        return *link;
+    }
+
+    void add_child(size_t node_index, size_t child) {
+        auto& link = find_child_link(node_index, edge_char(child));
+        nodes[child].next_sibling = link;
+        link = static_cast<Index>(child);
+    }
+
+    // put a new child instead of an old one starting with the same char
+    void replace_child(size_t node_index, size_t old_child, size_t new_child) {
+        auto& link = find_child_link(node_index, edge_char(old_child));
+        nodes[new_child].next_sibling = nodes[old_child].next_sibling;
+        nodes[old_child].next_sibling = 0;
+        link = static_cast<Index>(new_child);
+    }
+
+    void add_suffix_link(size_t node_index) {
+        if (need_sl_index > 0) {
+            suff_links[need_sl_index] = static_cast<Index>(node_index);
+        }
+        need_sl_index = node_index;
+    }
+
+    bool walk_down(size_t node_index) {
+        auto edge_length = get_node_length(node_index);
+        if (active_node_length < edge_length) {
+            return false;
+        }
+        active_edge_index += edge_length;
+        active_node_length -= edge_length;
+        active_node_index = node_index;
+        return true;
+    }
+
+    void extend() {
+        need_sl_index = 0;
+        ++remainder;
+        while (remainder) {
+            if (active_node_length == 0) {
+                active_edge_index = text_length;
+            }
+            const auto edge_index = find_child(active_node_index, active_edge_char());
+            if (!edge_index) {
+                add_child(active_node_index, add_node(text_length));
+                add_suffix_link(active_node_index);
+            } else {
+                // Observation 1:
+                // When the final suffix we need to insert is found to exist in the tree already,
+                // the tree itself is not changed at all(we only update the active point and remainder)
+                if (walk_down(edge_index)) {
+                    SUFFIX_TREE_COUNT(walk_down_skips);
+                    continue;
+                }
+
+                const size_t edge_left_pos = nodes[edge_index].l;
+                const auto edge_right_pos = edge_left_pos + active_node_length;
+                // Observation 2
+                // If at some point active_length is greater or equal to the length of current edge (edge_length),
+                // we move our active point down until edge_length is strictly greater than active_length.
+                const auto cur_char = text[text_length];
+                if (text[edge_right_pos] == cur_char) {
+                    ++active_node_length;
+                    // Observation 3
+                    // When the symbol we want to add to the tree is already on the edge, we, according to Observation 1,
+                    // update only active point and remainder, leaving the tree unchanged.
+                    // BUT if there is an internal node marked as needing suffix link,
+                    // we must connect that node with our current active node through a suffix link.
+                    add_suffix_link(active_node_index);
+                    break;
+                }
+                const auto mid_index = add_node(edge_left_pos, edge_right_pos); // Add a new middle node
+                SUFFIX_TREE_COUNT(splits);
+                begin_split();
+                replace_child(active_node_index, edge_index, mid_index); // Relink active node edge to middle node
+                add_child(mid_index, add_node(text_length)); // Add a new leaf node and mid_node-new_leaf link
+                nodes[edge_index].l += static_cast<Index>(active_node_length);
+                add_child(mid_index, edge_index); // Add mid_node-old_leaf link
+                end_split();
+                // Rule 2
+                // If we create a new internal node OR make an inserter from an internal node,
+                // and this is not the first SUCH internal node at current step,
+                // then we link the previous SUCH node with THIS one through a suffix link.
+                add_suffix_link(mid_index);
+            }
+            --remainder;
+            if (active_node_index == 0 && active_node_length > 0) {
+                // Rule 1
+                // If after an insertion from the active node = root, the active length is greater than 0, then:
+                // 1. active node is not changed
+                // 2. active length is decremented
+                // 3. active edge is shifted right(to the first character of the next suffix we must insert)
+                --active_node_length;
+                active_edge_index = text_length - remainder + 1;
+            } else {
+                // Rule 3
+                // After an insert from the active node which is not the root node,
+                // we must follow the suffix linkand set the active node to the node it points to.
+                // If there is no a suffix link, set the active node to the root node.
+                // Either way, active edge and active length stay unchanged.
+                active_node_index = suff_links[active_node_index];
+                if (active_node_index) {
+                    SUFFIX_TREE_COUNT(suffix_link_follows);
+                }
+            }
+        }
+    }
+
+    void begin_split() {
+        if constexpr (SHARED_READS) {
+            splits_version.store(splits_version.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+    }
+
+    void end_split() {
+        if constexpr (SHARED_READS) {
+            splits_version.store(splits_version.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+    }
+
+    void pretty_print() {
+        std::cout << text.substr(0, text_length + 1) << "\n";
+        std::cout << "active index=" << active_node_index << " edge=" << active_edge_char() << " length=" << active_node_length << "\n";
+        std::string pad;
+        traverse([&](size_t node_index, size_t) {
+            const auto suff_link = suff_links[node_index];
+            const std::string suff_str = suff_link ? "(" + std::to_string(suff_link) + ")" : "";
+            std::cout << pad << node_index << suff_str << " " << text.substr(nodes[node_index].l, get_node_length(node_index)) << "\n";
+            pad += "  ";
+        }, [&](size_t, size_t) {
+            pad.resize(pad.size() - 2);
+        });
+        std::cout << "\n";
+    }
+
+protected:
+    bool terminated = false;
+    size_t need_sl_index = 0; // node, that needs a suffix link
+    size_t active_node_index = 0; // index of active node
+    size_t active_edge_index = 0; // index of active edge char in text
+    size_t active_node_length = 0; // distance between current position and beggining of active node position
+    size_t remainder = 0; // how many leafs to add to make tree completed (with active_node_length=0)
+    size_t text_length = 0; // length of processed text
+    Text& text;
+    SegmentedPool<Node> nodes{ Node(0, 0) };
+    SegmentedPool<Index> suff_links{ 0 };
+    std::atomic<size_t> splits_version{ 0 }; // odd while an edge is split, see SHARED_READS
+private:
+    struct {
+        size_t walk_down_skips = 0;
+        size_t suffix_link_follows = 0;
+        size_t splits = 0;
+    } build_counters;
+};
+
+using Tree = BasicTree<uint32_t>;
+
+#undef SUFFIX_TREE_COUNT
+
+#endif // !SUFFIX_TREE_HPP